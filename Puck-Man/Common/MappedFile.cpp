@@ -0,0 +1,96 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace commoncore
+{
+	bool CMappedFile::Open(const std::string& filename, FileAccess access)
+	{
+		Close();
+
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			access == RandomAccess ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// files without bytes can't be mapped
+		if (size.QuadPart != 0)
+		{
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				CloseHandle(mapping);
+			}
+			if (_data == nullptr)
+			{
+				CloseHandle(file);
+				return false;
+			}
+		}
+		CloseHandle(file);
+		_size = static_cast<size_t>(size.QuadPart);
+#else
+		int file = open(filename.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat status;
+		if (fstat(file, &status) != 0)
+		{
+			close(file);
+			return false;
+		}
+
+		// files without bytes can't be mapped
+		if (status.st_size != 0)
+		{
+			void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (data == MAP_FAILED)
+			{
+				close(file);
+				return false;
+			}
+			// a file read once from the start to the end is read ahead, the pages of the others are
+			// only loaded when they are touched
+			madvise(data, static_cast<size_t>(status.st_size), access == RandomAccess ? MADV_RANDOM : MADV_SEQUENTIAL);
+			_data = static_cast<const char*>(data);
+		}
+		close(file);
+		_size = static_cast<size_t>(status.st_size);
+#endif
+
+		_open = true;
+		return true;
+	}
+
+	void CMappedFile::Close()
+	{
+		if (_data != nullptr)
+		{
+#if defined(_WIN32)
+			UnmapViewOfFile(_data);
+#else
+			munmap(const_cast<char*>(_data), _size);
+#endif
+		}
+		_data = nullptr;
+		_size = 0;
+		_open = false;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef PUCKMAN_COMMON_MAPPEDFILE_H_
+#define PUCKMAN_COMMON_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace commoncore
+{
+	// how the mapped bytes are going to be read, the system reads ahead of the sequential ones
+	const enum FileAccess
+	{
+		SequentialAccess = 0,
+		RandomAccess,
+		FileAccess_Size
+	};
+
+	/*
+	*  Mapped file class, maps a whole file on memory for reading so it can be parsed in place
+	*  without copying it through a stream
+	*/
+	class CMappedFile
+	{
+	public:
+		CMappedFile() : _data{ nullptr }, _size{ 0 }, _open{ false } {}
+		~CMappedFile() { Close(); }
+
+		// map a file, an empty file is opened with no data
+		bool Open(const std::string& filename, FileAccess access = SequentialAccess);
+		// unmap the file, the data is no longer valid
+		void Close();
+
+		bool IsOpen() { return _open; }
+
+		// bytes of the file, it's not terminated by a null character
+		const char* Data() { return _data; }
+		size_t Size() { return _size; }
+
+	private:
+		/* remove these features to avoid unmapping the same file twice */
+		// remove the copy constructor
+		CMappedFile(const CMappedFile& src) = delete;
+		// remove the copy assign operator
+		const CMappedFile& operator=(const CMappedFile& rhs) = delete;
+
+		// the view keeps the file alive, its handles are closed as soon as it's mapped
+		const char* _data;
+		size_t _size;
+		bool _open;
+	};
+}
+
+#endif // PUCKMAN_COMMON_MAPPEDFILE_H_
@@ -0,0 +1,105 @@
+#include <cerrno>
+#include "TickScheduler.h"
+
+#if defined(__linux__)
+#include <time.h>
+#elif defined(_WIN32)
+#include <thread>
+#include <windows.h>
+#pragma comment(lib,"winmm")
+#else
+#include <thread>
+#endif
+
+namespace commoncore
+{
+	const std::array<long long, CJitterHistogram::BUCKETS - 1> CJitterHistogram::LIMITS = { { 50, 100, 250, 500, 1000, 2000, 5000, 10000 } };
+
+	void CJitterHistogram::Add(std::chrono::steady_clock::duration lateness)
+	{
+		long long us = std::chrono::duration_cast<std::chrono::microseconds>(lateness).count();
+		int bucket = 0;
+		while (bucket < BUCKETS - 1 && us >= LIMITS[bucket])
+			++bucket;
+		++_buckets[bucket];
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const CJitterHistogram& histogram)
+	{
+		bool first = true;
+		for (int i = 0; i < CJitterHistogram::BUCKETS; ++i)
+		{
+			if (histogram._buckets[i] == 0)
+				continue;
+			stream << (first ? "" : " ");
+			if (i < CJitterHistogram::BUCKETS - 1)
+				stream << "<" << CJitterHistogram::LIMITS[i] << "us:";
+			else
+				stream << ">=" << CJitterHistogram::LIMITS[i - 1] << "us:";
+			stream << histogram._buckets[i];
+			first = false;
+		}
+		return stream;
+	}
+
+	CTickScheduler::CTickScheduler(Duration period, TickPolicy policy, int maxCatchUp) :
+		_period{ period }, _policy{ policy }, _maxCatchUp{ maxCatchUp }, _dropped{ 0 }
+	{
+#if defined(_WIN32)
+		// the default resolution of the Windows sleeps is around 15 ms
+		timeBeginPeriod(1);
+#endif
+	}
+
+	CTickScheduler::~CTickScheduler()
+	{
+#if defined(_WIN32)
+		timeEndPeriod(1);
+#endif
+	}
+
+	void CTickScheduler::Start()
+	{
+		_next = std::chrono::steady_clock::now() + _period;
+		_tick = _next - _period;
+	}
+
+	void CTickScheduler::Wait()
+	{
+		SleepUntil(_next);
+
+		auto now = std::chrono::steady_clock::now();
+		_jitter.Add(now - _next);
+		_tick = _next;
+		_next += _period;
+
+		// the deadlines always stay on the cadence of the first one, the late ticks are
+		// either run right away or skipped as a whole
+		if (now >= _next)
+		{
+			auto late = (now - _next) / _period + 1;
+			if (_policy == Drop || late > _maxCatchUp)
+			{
+				long long skipped = _policy == Drop ? late : late - _maxCatchUp;
+				_next += _period * skipped;
+				_dropped += static_cast<unsigned int>(skipped);
+			}
+		}
+	}
+
+	void CTickScheduler::SleepUntil(TimePoint deadline)
+	{
+#if defined(__linux__)
+		// the steady clock of libstdc++ and libc++ is CLOCK_MONOTONIC, so its time points can be
+		// given as absolute deadlines and the sleep doesn't drift with the time spent computing them
+		auto since = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+		timespec request;
+		request.tv_sec = static_cast<time_t>(since / 1000000000);
+		request.tv_nsec = static_cast<long>(since % 1000000000);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &request, nullptr) == EINTR)
+			;
+#else
+		std::this_thread::sleep_until(deadline);
+#endif
+	}
+}
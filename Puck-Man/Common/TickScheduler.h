@@ -0,0 +1,96 @@
+#pragma once
+
+#ifndef PUCKMAN_COMMON_TICKSCHEDULER_H_
+#define PUCKMAN_COMMON_TICKSCHEDULER_H_
+
+#include <array>
+#include <chrono>
+#include <ostream>
+
+namespace commoncore
+{
+	// what the scheduler does with the ticks whose deadline passed while the previous one was running
+	const enum TickPolicy
+	{
+		// run them back to back, up to a limit, so the game time never falls behind
+		CatchUp = 0,
+		// skip them and wait for the next deadline of the cadence
+		Drop
+	};
+
+	/*
+	*  Jitter histogram class, counts how late each tick started after its deadline
+	*/
+	class CJitterHistogram
+	{
+	public:
+		// upper limit in microseconds of each bucket, the last bucket takes everything above
+		static const int BUCKETS = 9;
+		static const std::array<long long, BUCKETS - 1> LIMITS;
+
+		CJitterHistogram() { Clear(); }
+		~CJitterHistogram() = default;
+
+		// add the lateness of a tick
+		void Add(std::chrono::steady_clock::duration lateness);
+		// forget the samples of the current period
+		void Clear() { _buckets.fill(0); }
+
+		// print the buckets with at least one sample
+		friend std::ostream& operator<<(std::ostream& stream, const CJitterHistogram& histogram);
+
+	private:
+		std::array<unsigned int, BUCKETS> _buckets;
+	};
+
+	/*
+	*  Tick scheduler class, wakes a thread up on an exact cadence of absolute deadlines taken from a
+	*  monotonic clock, so the time spent on a tick never delays the next ones
+	*/
+	class CTickScheduler
+	{
+	public:
+		typedef std::chrono::steady_clock::time_point TimePoint;
+		typedef std::chrono::steady_clock::duration Duration;
+
+		CTickScheduler(Duration period, TickPolicy policy, int maxCatchUp);
+		~CTickScheduler();
+
+		// set the first deadline one period from now
+		void Start();
+		// sleep until the deadline of the next tick, its lateness is added to the histogram
+		void Wait();
+
+		// deadline of the tick that was just waited for
+		TimePoint Deadline() { return _tick; }
+		// period between ticks
+		Duration Period() { return _period; }
+
+		// get/set what to do with the late ticks
+		TickPolicy Policy() { return _policy; }
+		void Policy(TickPolicy policy) { _policy = policy; }
+
+		// lateness of the ticks and ticks skipped since the last clear
+		const CJitterHistogram& Jitter() { return _jitter; }
+		unsigned int Dropped() { return _dropped; }
+		void ClearStats() { _jitter.Clear(); _dropped = 0; }
+
+	private:
+		// block the thread until the given time of the monotonic clock
+		static void SleepUntil(TimePoint deadline);
+
+		Duration _period;
+		TickPolicy _policy;
+		// number of late ticks that are run back to back before dropping the rest
+		int _maxCatchUp;
+
+		// deadline of the current tick and of the next one
+		TimePoint _tick;
+		TimePoint _next;
+
+		CJitterHistogram _jitter;
+		unsigned int _dropped;
+	};
+}
+
+#endif // PUCKMAN_COMMON_TICKSCHEDULER_H_
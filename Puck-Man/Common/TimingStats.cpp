@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <iomanip>
+#include "TimingStats.h"
+
+namespace commoncore
+{
+	void CTimingStats::Add(Duration duration)
+	{
+		++_count;
+		_total += duration;
+		_max = std::max(_max, duration);
+	}
+
+	void CTimingStats::Clear()
+	{
+		_count = 0;
+		_total = Duration::zero();
+		_max = Duration::zero();
+	}
+
+	double CTimingStats::AverageMs() const
+	{
+		if (_count == 0)
+			return 0.0;
+		return std::chrono::duration<double, std::milli>(_total).count() / _count;
+	}
+
+	double CTimingStats::MaxMs() const
+	{
+		return std::chrono::duration<double, std::milli>(_max).count();
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const CTimingStats& stats)
+	{
+		return stream << stats.Count() << " (avg " << std::fixed << std::setprecision(2) << stats.AverageMs()
+			<< " ms, max " << stats.MaxMs() << " ms)" << std::defaultfloat;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef PUCKMAN_COMMON_TIMINGSTATS_H_
+#define PUCKMAN_COMMON_TIMINGSTATS_H_
+
+#include <chrono>
+#include <ostream>
+
+namespace commoncore
+{
+	/*
+	*  Timing stats class, accumulates the durations of a repeated task (a tick, a frame) over a period
+	*/
+	class CTimingStats
+	{
+	public:
+		typedef std::chrono::steady_clock::duration Duration;
+
+		CTimingStats() { Clear(); }
+		~CTimingStats() = default;
+
+		// add the duration of one execution of the task
+		void Add(Duration duration);
+		// forget the samples of the current period
+		void Clear();
+
+		// number of executions, average and worst duration of the period
+		unsigned int Count() const { return _count; }
+		double AverageMs() const;
+		double MaxMs() const;
+
+		// print a short summary of the period
+		friend std::ostream& operator<<(std::ostream& stream, const CTimingStats& stats);
+
+	private:
+		unsigned int _count;
+		Duration _total;
+		Duration _max;
+	};
+}
+
+#endif // PUCKMAN_COMMON_TIMINGSTATS_H_
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef PUCKMAN_COMMON_TRIPLEBUFFER_H_
+#define PUCKMAN_COMMON_TRIPLEBUFFER_H_
+
+#include <array>
+#include <atomic>
+
+namespace commoncore
+{
+	/*
+	*  Triple buffer class, lets a single producer publish whole values to a single consumer without locks,
+	*  the producer never waits for the consumer and the consumer always gets the latest published value
+	*/
+	template<typename T>
+	class CTripleBuffer
+	{
+	public:
+		CTripleBuffer() : _back{ 0 }, _middle{ 1 }, _front{ 2 } {}
+		~CTripleBuffer() = default;
+
+		/* producer side */
+		// slot where the producer writes the next value
+		T& Back() { return _slots[_back]; }
+		// make the back slot visible to the consumer and take the stale one in exchange
+		void Publish() { _back = _middle.exchange(_back | FRESH, std::memory_order_acq_rel) & INDEX; }
+
+		/* consumer side */
+		// take the latest published value if there's a new one, returns false if the front slot is still the latest
+		bool Acquire()
+		{
+			if ((_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+				return false;
+			_front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX;
+			return true;
+		}
+		// slot that the consumer reads, it doesn't change until the next acquire
+		T& Front() { return _slots[_front]; }
+
+	private:
+		// the middle index is flagged when it holds a value that the consumer hasn't taken yet
+		static const unsigned int FRESH = 4;
+		static const unsigned int INDEX = 3;
+
+		std::array<T, 3> _slots;
+
+		// each index is owned by one side, they are kept apart to avoid false sharing
+		alignas(64) unsigned int _back;
+		alignas(64) std::atomic<unsigned int> _middle;
+		alignas(64) unsigned int _front;
+
+		/* remove these features, the slots are owned by the threads */
+		// remove the copy constructor
+		CTripleBuffer(const CTripleBuffer& src) = delete;
+		// remove the copy assign operator
+		const CTripleBuffer& operator=(const CTripleBuffer& rhs) = delete;
+	};
+}
+
+#endif // PUCKMAN_COMMON_TRIPLEBUFFER_H_
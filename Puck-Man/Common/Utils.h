@@ -18,7 +18,10 @@ static const int WINDOW_HEIGHT = 648;
 static const int SCREEN_WIDTH_TILES = 28;
 static const int SCREEN_HEIGHT_TILES = 36;
 
-static const int SCREEN_FPS = 10;
+// simulation ticks per second, the screen is refreshed as fast as the display allows
+static const int TICKS_PER_SECOND = 10;
+// maximum number of late ticks that the simulation catches up before dropping them
+static const int MAX_CATCH_UP_TICKS = 5;
 
 // valid colors for the screen elements
 const enum Color
@@ -61,9 +64,6 @@ const enum TextSize
 	BIG = 45
 };
 
-inline float TextScale(TextSize size) { return (size / 100.0f); }
-inline int   TextOffset(TextSize size, char* text) { return (static_cast<int>(0.35 * std::char_traits<char>::length(text) * size)); }
-
 struct LFRect
 {
 	GLfloat x;
@@ -81,4 +81,8 @@ const enum GameState
 	GamePaused
 };
 
+// points given for each element eaten by Pacman
+static const int PILL_POINTS = 10;
+static const int ENERGIZER_POINTS = 50;
+
 #endif // PUCKMAN_COMMON_UTILS_H_
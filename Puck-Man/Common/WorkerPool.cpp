@@ -0,0 +1,83 @@
+#include <algorithm>
+#include "WorkerPool.h"
+
+namespace commoncore
+{
+	CWorkerPool::CWorkerPool(size_t threads) : _job{ nullptr }, _items{ 0 }, _generation{ 0 }, _pending{ 0 }, _stop{ false }
+	{
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		// the calling thread also takes a share of every job
+		for (size_t i = 1; i < threads; ++i)
+			_workers.emplace_back(&CWorkerPool::Work, this, i);
+	}
+
+	CWorkerPool::~CWorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ _mutex };
+			_stop = true;
+		}
+		_start.notify_all();
+		for (auto& worker : _workers)
+			worker.join();
+	}
+
+	void CWorkerPool::Run(size_t items, const Job& job)
+	{
+		// there's no need to wake up the workers for a single share
+		if (_workers.empty() || items < 2)
+		{
+			job(0, items);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{ _mutex };
+			_job = &job;
+			_items = items;
+			_pending = _workers.size();
+			++_generation;
+		}
+		_start.notify_all();
+
+		// the first share belongs to the calling thread
+		job(0, items / Size());
+
+		std::unique_lock<std::mutex> lock{ _mutex };
+		_done.wait(lock, [this] { return _pending == 0; });
+		_job = nullptr;
+	}
+
+	void CWorkerPool::Work(size_t index)
+	{
+		unsigned long long generation = 0;
+		for (;;)
+		{
+			const Job* job;
+			size_t items;
+			{
+				std::unique_lock<std::mutex> lock{ _mutex };
+				_start.wait(lock, [&] { return _stop || _generation != generation; });
+				if (_stop)
+					return;
+				generation = _generation;
+				job = _job;
+				items = _items;
+			}
+
+			// process the contiguous share of items that belongs to this worker
+			size_t begin = items * index / Size();
+			size_t end = items * (index + 1) / Size();
+			if (begin != end)
+				(*job)(begin, end);
+
+			{
+				std::lock_guard<std::mutex> lock{ _mutex };
+				--_pending;
+			}
+			_done.notify_one();
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef PUCKMAN_COMMON_WORKERPOOL_H_
+#define PUCKMAN_COMMON_WORKERPOOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace commoncore
+{
+	/*
+	*  Worker pool class, keeps a set of threads alive to split a range of work items between them
+	*/
+	class CWorkerPool
+	{
+	public:
+		// job that processes the items on the range [begin, end)
+		typedef std::function<void(size_t begin, size_t end)> Job;
+
+		// create the pool, zero threads means one per hardware core
+		explicit CWorkerPool(size_t threads = 0);
+		~CWorkerPool();
+
+		// number of threads that run a job, including the calling thread
+		size_t Size() { return _workers.size() + 1; }
+
+		// split the items between the threads and wait until all of them are processed
+		void Run(size_t items, const Job& job);
+
+	private:
+		// method executed by each one of the worker threads
+		void Work(size_t index);
+
+		std::vector<std::thread> _workers;
+
+		std::mutex _mutex;
+		std::condition_variable _start;
+		std::condition_variable _done;
+
+		// job being executed, it is only referenced during Run
+		const Job* _job;
+		// number of items of the current job
+		size_t _items;
+		// incremented every time a new job is started
+		unsigned long long _generation;
+		// number of workers that haven't finished the current job
+		size_t _pending;
+		bool _stop;
+
+		/* remove these features to avoid copies of the threads */
+		// remove the copy constructor
+		CWorkerPool(const CWorkerPool& src) = delete;
+		// remove the copy assign operator
+		const CWorkerPool& operator=(const CWorkerPool& rhs) = delete;
+	};
+}
+
+#endif // PUCKMAN_COMMON_WORKERPOOL_H_
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cmath>
+#include "Autopilot.h"
+
+namespace gamecore
+{
+	// maximum number of nodes of each search tree, the memory is reserved once
+	static const size_t MAX_TREE_NODES = 1 << 16;
+
+	CAutopilot::CAutopilot() : _root{ nullptr }, _rollouts{ 0 }, _rolloutsPerSecond{ 0 }
+	{
+		// by default use half of each tick to search
+		_settings = AutopilotSettings{ 500 / TICKS_PER_SECOND, 0, 12, 24, 1.4 };
+
+		_job = [this](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				Search(_searchers[i]);
+		};
+	}
+
+	Direction CAutopilot::Choose(CWorld& world)
+	{
+		// create the threads and their trees the first time they are needed
+		if (!_pool)
+		{
+			_pool.reset(new commoncore::CWorkerPool{ _settings.threads });
+			_searchers.resize(_pool->Size());
+			for (size_t i = 0; i < _searchers.size(); ++i)
+			{
+				_searchers[i].tree.reserve(MAX_TREE_NODES);
+				_searchers[i].path.reserve(_settings.treeDepth + 1);
+				_searchers[i].random.seed(static_cast<unsigned int>(i) + 1);
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		_root = &world;
+		_deadline = start + std::chrono::milliseconds(_settings.budget);
+
+		// one searcher per thread
+		_pool->Run(_searchers.size(), _job);
+
+		// add the visits given by every tree to each direction of the root
+		std::array<unsigned long long, 4> visits{};
+		_rollouts = 0;
+		for (auto& searcher : _searchers)
+		{
+			_rollouts += searcher.rollouts;
+			for (int dir = Left; dir <= Down; ++dir)
+				if (searcher.tree[0].children[dir] != 0)
+					visits[dir] += searcher.tree[searcher.tree[0].children[dir]].visits;
+		}
+
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		_rolloutsPerSecond = elapsed.count() > 0 ? _rollouts / elapsed.count() : 0;
+
+		// keep the current direction if there was no time to search
+		Direction best = world.Pacman().Facing();
+		unsigned long long most = 0;
+		for (int dir = Left; dir <= Down; ++dir)
+		{
+			if (visits[dir] > most)
+			{
+				most = visits[dir];
+				best = static_cast<Direction>(dir);
+			}
+		}
+		return best;
+	}
+
+	void CAutopilot::Search(Searcher& searcher)
+	{
+		// start a new tree from the current root
+		searcher.tree.clear();
+		searcher.tree.push_back(Node{});
+		searcher.rollouts = 0;
+
+		do
+		{
+			Rollout(searcher);
+			++searcher.rollouts;
+		} while (std::chrono::steady_clock::now() < _deadline);
+	}
+
+	double CAutopilot::Rollout(Searcher& searcher)
+	{
+		auto& world = searcher.world;
+		auto& tree = searcher.tree;
+		auto& path = searcher.path;
+
+		// replay from a fresh copy of the root with its own random ghost moves
+		world = *_root;
+		world.Seed(searcher.random());
+
+		int points = 0;
+		unsigned int steps = 0;
+		bool caught = false;
+		bool cleared = false;
+
+		// play one move of Pacman and the ghosts
+		auto play = [&](Direction dir)
+		{
+			world.Pacman().ChangeDirection(dir);
+			auto result = world.Step();
+			points += result.reward;
+			caught = result.caught;
+			cleared = result.cleared;
+			++steps;
+		};
+
+		/* selection and expansion */
+		unsigned int node = 0;
+		path.clear();
+		path.push_back(node);
+		for (unsigned int depth = 0; depth < _settings.treeDepth && !caught && !cleared; ++depth)
+		{
+			// expand the first direction that hasn't been tried, starting at a random one
+			int offset = searcher.random() % 4;
+			int expand = -1;
+			for (int i = 0; i < 4 && expand < 0; ++i)
+				if (tree[node].children[(offset + i) % 4] == 0)
+					expand = (offset + i) % 4;
+
+			if (expand >= 0 && tree.size() < MAX_TREE_NODES)
+			{
+				tree[node].children[expand] = static_cast<unsigned int>(tree.size());
+				tree.push_back(Node{});
+				play(static_cast<Direction>(expand));
+				node = tree[node].children[expand];
+				path.push_back(node);
+				break;
+			}
+			// stop descending when the tree can't grow anymore
+			if (expand >= 0)
+				break;
+
+			// choose the child with the best upper confidence bound
+			int best = 0;
+			double bestBound = -HUGE_VAL;
+			double logVisits = std::log(static_cast<double>(tree[node].visits) + 1);
+			for (int dir = Left; dir <= Down; ++dir)
+			{
+				auto& child = tree[tree[node].children[dir]];
+				double bound = child.value / child.visits + _settings.exploration * std::sqrt(logVisits / child.visits);
+				if (bound > bestBound)
+				{
+					bestBound = bound;
+					best = dir;
+				}
+			}
+			play(static_cast<Direction>(best));
+			node = tree[node].children[best];
+			path.push_back(node);
+		}
+
+		/* simulation, Pacman mostly keeps its direction */
+		for (unsigned int i = 0; i < _settings.rolloutDepth && !caught && !cleared; ++i)
+		{
+			auto dir = world.Pacman().Facing();
+			if (searcher.random() % 4 == 0)
+				dir = static_cast<Direction>(searcher.random() % 4);
+			play(dir);
+		}
+
+		// being caught is the worst outcome and clearing the level the best one, otherwise
+		// the value is the fraction of the ticks in which Pacman has eaten a pill
+		double value = caught ? -1.0 : (cleared ? 1.0 : static_cast<double>(points) / (PILL_POINTS * std::max(steps, 1u)));
+
+		/* backpropagation */
+		for (auto visited : path)
+		{
+			++tree[visited].visits;
+			tree[visited].value += value;
+		}
+
+		return value;
+	}
+}
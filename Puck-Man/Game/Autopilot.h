@@ -0,0 +1,96 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_AUTOPILOT_H_
+#define PUCKMAN_GAME_AUTOPILOT_H_
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include "World.h"
+#include "../Common/WorkerPool.h"
+
+namespace gamecore
+{
+	// settings of the autopilot search
+	struct AutopilotSettings
+	{
+		// time given to the search on each tick, in milliseconds
+		unsigned int budget;
+		// threads that run rollouts, zero means one per hardware core
+		size_t threads;
+		// maximum depth of the search tree, in ticks
+		unsigned int treeDepth;
+		// ticks simulated after leaving the tree
+		unsigned int rolloutDepth;
+		// weight of the exploration term of UCB1
+		double exploration;
+	};
+
+	/*
+	*  Autopilot class, picks the direction of Pacman with Monte Carlo tree search over copies of the world,
+	*  every thread grows its own tree and the visits of the root moves are added at the end of the tick
+	*/
+	class CAutopilot
+	{
+	public:
+		CAutopilot();
+		~CAutopilot() = default;
+
+		// get/set the search settings, the threads are created again on the next search
+		AutopilotSettings Settings() { return _settings; }
+		void Settings(const AutopilotSettings& settings) { _settings = settings; _pool.reset(); }
+
+		// search the best direction for Pacman from the state of the given world
+		Direction Choose(CWorld& world);
+
+		// rollouts executed on the last search
+		unsigned long long Rollouts() { return _rollouts; }
+		// throughput of the last search
+		double RolloutsPerSecond() { return _rolloutsPerSecond; }
+
+	private:
+		// node of a search tree, the state is obtained replaying the moves from the root
+		struct Node
+		{
+			// index of the child for each direction, zero when it hasn't been expanded
+			std::array<unsigned int, 4> children;
+			unsigned int visits;
+			double value;
+		};
+
+		// state owned by each one of the searching threads
+		struct Searcher
+		{
+			std::vector<Node> tree;
+			// nodes visited by the current rollout
+			std::vector<unsigned int> path;
+			// copy of the root world that is played on each rollout
+			CWorld world;
+			std::minstd_rand random;
+			unsigned long long rollouts;
+		};
+
+		AutopilotSettings _settings;
+
+		std::unique_ptr<commoncore::CWorkerPool> _pool;
+		std::vector<Searcher> _searchers;
+		commoncore::CWorkerPool::Job _job;
+
+		// world being searched and end of the search
+		CWorld* _root;
+		std::chrono::steady_clock::time_point _deadline;
+
+		unsigned long long _rollouts;
+		double _rolloutsPerSecond;
+
+		// grow the tree of a searcher until the deadline
+		void Search(Searcher& searcher);
+
+		// play one rollout from the root, returns its value
+		double Rollout(Searcher& searcher);
+	};
+}
+
+#endif // PUCKMAN_GAME_AUTOPILOT_H_
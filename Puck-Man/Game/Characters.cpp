@@ -1,71 +1,150 @@
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include "Characters.h"
 #include "Scenario.h"
+#include "World.h"
+#include "../Graphics/RenderBackend.h"
 #include "../Game/Game.h"
 
 #define Scenario        CGame::Instance().Scenario()
 #define ScenarioData    Scenario.Data()
-#define Clip(type)      &ScenarioData.Clippings(type)
 #define Grid            CGridWithWeights::Instance()
-#define Pacman          CGame::Instance().Pacman()
 
 namespace gamecore
 {
 	// set up the directions
 	std::array<CSquareGrid::Location, 4> CSquareGrid::DIRS{ { Location{ 1, 0 }, Location{ 0, -1 }, Location{ -1, 0 }, Location{ 0, 1 } } };
 
-	void CCharacter::Render()
+	void CCharacter::Render(graphicscore::CRenderBackend& backend, GLfloat alpha)
+	{
+		GLfloat x, y;
+		SpritePosition(alpha, x, y);
+		backend.DrawSprite(x, y, _c);
+	}
+
+	void CCharacter::SpritePosition(GLfloat alpha, GLfloat& x, GLfloat& y)
 	{
 		using graphicscore::SIZE_OF_TILE;
 		using graphicscore::SIZE_OF_CHARACTER;
 
+		// move the character from its previous position, unless it has jumped through the
+		// wrap zone or has been reset, then it is shown directly on its new position
+		x = static_cast<GLfloat>(_x);
+		y = static_cast<GLfloat>(_y);
+		if (std::abs(_x - _px) <= 2 * FIXED_ONE && std::abs(_y - _py) <= 2 * FIXED_ONE)
+		{
+			x = _px + (_x - _px) * alpha;
+			y = _py + (_y - _py) * alpha;
+		}
+
 		// the center of a character is located in a different point that the start of the sprite
 		// texture, the sprite size is 33x33 pixels and the tile size is 18x18, the coordinates to be
 		// sent to the screen are different that the ones hold inside of the object, they referred
 		// to a 28x36 tiles scenario
-		ScenarioData.RenderTexture((_x * SIZE_OF_TILE) - 1 - (SIZE_OF_CHARACTER - SIZE_OF_TILE) / 2,
-			(_y * SIZE_OF_TILE) - (SIZE_OF_CHARACTER - SIZE_OF_TILE) / 2,
-			Clip(_c));
+		x = (x * SIZE_OF_TILE / FIXED_ONE) - 1 - (SIZE_OF_CHARACTER - SIZE_OF_TILE) / 2;
+		y = (y * SIZE_OF_TILE / FIXED_ONE) - (SIZE_OF_CHARACTER - SIZE_OF_TILE) / 2;
 	}
 
-	void CPacman::Move()
+	void CCharacter::MarkDirty(CTileBitmap& dirty)
 	{
-		// if Pacman has reached either the left side or right side of the wrap zone
-		// change its location to the opposite location
-		if (_y == 17)
+		using graphicscore::SIZE_OF_TILE;
+		using graphicscore::SIZE_OF_CHARACTER;
+
+		// tile of a pixel, the sprites can be partially out of the screen
+		auto tile = [](int pixel) { return (pixel + SIZE_OF_TILE) / SIZE_OF_TILE - 1; };
+		// pixels covered by the sprite between two fixed point positions, like on Render plus a
+		// pixel of margin on each side for the rounding and the texture filtering
+		auto mark = [&](int left, int top, int right, int bottom)
 		{
-			if (_x == 0)
-				_x = 27;
-			else if (_x == 27)
-				_x = 0;
-		}
+			const int offset = (SIZE_OF_CHARACTER - SIZE_OF_TILE) / 2;
+			left = left * SIZE_OF_TILE / FIXED_ONE - 1 - offset - 1;
+			right = right * SIZE_OF_TILE / FIXED_ONE - 1 - offset + SIZE_OF_CHARACTER;
+			top = top * SIZE_OF_TILE / FIXED_ONE - offset - 1;
+			bottom = bottom * SIZE_OF_TILE / FIXED_ONE - offset + SIZE_OF_CHARACTER;
+			// the columns are painted one pixel to the left of the rows
+			dirty.SetRect(tile(left + 1), tile(top), tile(right + 1), tile(bottom));
+		};
 
-		// move in the indicated position
-		switch (d)
+		// the jumps are shown without moving through the tiles in between, like Render does
+		if (std::abs(_x - _px) <= 2 * FIXED_ONE && std::abs(_y - _py) <= 2 * FIXED_ONE)
+			mark(std::min(_x, _px), std::min(_y, _py), std::max(_x, _px), std::max(_y, _py));
+		else
 		{
-		case Left:  if (Scenario.ElementsMatrix()[_x - 1][_y] != Wall) --_x; break;
-		case Right: if (Scenario.ElementsMatrix()[_x + 1][_y] != Wall) ++_x; break;
-		case Up:    if (Scenario.ElementsMatrix()[_x][_y - 1] != Wall) --_y; break;
-		case Down:  if (Scenario.ElementsMatrix()[_x][_y + 1] != Wall) ++_y; break;
-		default:    break;
+			mark(_px, _py, _px, _py);
+			mark(_x, _y, _x, _y);
 		}
+	}
 
-		// remove any decimal point from the position before moving Pacman
-		_x = static_cast<int>(_x);
-		_y = static_cast<int>(_y);
+	void CPacman::Move(CWorld& world)
+	{
+		auto& elements = world.Layout();
 
-		// if there's a pill in the position, take it and sum the value in the score
-		if (Scenario.ElementsMatrix()[_x][_y] == Pill)
+		// the screen wraps horizontally on the tunnel rows, the others end on their first and last tiles
+		auto open = [&](int x, int y)
 		{
-			// TODO: Add the pill to the score
-			Scenario.ElementsMatrix(_x, _y, Empty);
-		}
-		// if there was an energizer, change 
-		else if (Scenario.ElementsMatrix()[_x][_y] == Energizer)
+			if (x < 0 || x >= SCREEN_WIDTH_TILES)
+			{
+				if (!world.Tunnel(y))
+					return false;
+				x = (x + SCREEN_WIDTH_TILES) % SCREEN_WIDTH_TILES;
+			}
+			return elements[x][y] != Wall;
+		};
+
+		int x = _x >> FIXED_SHIFT;
+		int y = _y >> FIXED_SHIFT;
+
+		// Pacman only moves along the corridors, leave the other axis on its tile; while it
+		// is between two tiles it can go on, otherwise the next tile must not be a wall, and
+		// a single move never goes further than the next tile
+		switch (d)
 		{
-			// TODO: Implement the energizer behavior
-			Scenario.ElementsMatrix(_x, _y, Empty);
+		case Left:
+			_y = ToFixed(y);
+			if ((_x & FIXED_MASK) != 0)
+				_x -= std::min(_speed, _x & FIXED_MASK);
+			else if (open(x - 1, y))
+				_x -= _speed;
+			break;
+		case Right:
+			_y = ToFixed(y);
+			if ((_x & FIXED_MASK) != 0)
+				_x += std::min(_speed, FIXED_ONE - (_x & FIXED_MASK));
+			else if (open(x + 1, y))
+				_x += _speed;
+			break;
+		case Up:
+			_x = ToFixed(x);
+			if ((_y & FIXED_MASK) != 0)
+				_y -= std::min(_speed, _y & FIXED_MASK);
+			else if (elements[x][y - 1] != Wall)
+				_y -= _speed;
+			break;
+		case Down:
+			_x = ToFixed(x);
+			if ((_y & FIXED_MASK) != 0)
+				_y += std::min(_speed, FIXED_ONE - (_y & FIXED_MASK));
+			else if (elements[x][y + 1] != Wall)
+				_y += _speed;
+			break;
+		default:
+			break;
 		}
+
+		// if Pacman has left the screen through a tunnel move it to the opposite side
+		if (_x < 0)
+			_x += ToFixed(SCREEN_WIDTH_TILES);
+		else if (_x >= ToFixed(SCREEN_WIDTH_TILES))
+			_x -= ToFixed(SCREEN_WIDTH_TILES);
+
+		// Pacman eats the element of the tile that holds most of its body
+		std::tie(x, y) = Cell();
+
+		// if there's a pill or an energizer in the position, take it and sum the value in the score
+		// TODO: Implement the energizer behavior
+		if (world.Pills().Test(x, y))
+			world.Eat(x, y);
 	}
 
 	bool CGhost::Init()
@@ -73,106 +152,126 @@ namespace gamecore
 		// set the initial position of the ghost
 		if (_g == Red)
 		{
-			Position(13.5, 14);
+			Position(ToFixed(13) + FIXED_HALF, ToFixed(14));
 			Clipping(graphicscore::LR_GHOST);
 		}
 		else if (_g == Pink)
 		{
-			Position(11.5, 17);
+			Position(ToFixed(11) + FIXED_HALF, ToFixed(17));
 			Clipping(graphicscore::LP_GHOST);
 		}
 		else if (_g == Blue)
 		{
-			Position(13.5, 17);
+			Position(ToFixed(13) + FIXED_HALF, ToFixed(17));
 			Clipping(graphicscore::LB_GHOST);
 		}
 		else
 		{
-			Position(15.5, 17);
+			Position(ToFixed(15) + FIXED_HALF, ToFixed(17));
 			Clipping(graphicscore::LO_GHOST);
 		}
 
+		// the ghosts start between two tiles, first they settle on the tile at their left
+		_next = Position();
+
 		return true;
 	}
 
-	void CGhost::Move()
+	void CGhost::Move(CWorld& world)
 	{
+		// the path is only searched again once the ghost has reached the next tile
+		if (!Aligned())
+		{
+			Approach();
+			return;
+		}
+
+		// every ghost chases the current location of Pacman
+		auto target = world.Pacman().Position();
+
 		/* move the ghost depending on the color */
-		// the red ghost moves using the bread first search algorithm
+		// the red ghost moves using the bread first search algorithm, the compiled level has its steps
 		if (_g == Red)
 		{
-			auto path = Grid.ReconstructPath(Position(), Pacman.Position(), Grid.BreadthFirstSearch(Grid, Position(), Pacman.Position()));
-			if (path.size() != 0)
-				Position(path.back());
+			if (!Grid.FollowPath(BreadthFirstPaths, Position(), target, _next))
+			{
+				auto came_from = Grid.BreadthFirstSearch(Grid, Position(), target);
+				auto path = Grid.ReconstructPath(Position(), target, came_from);
+				if (path.size() != 0)
+					_next = path.back();
+			}
 		}
-		// the pink ghost moves using the Djikstra search algorithm
+		// the pink ghost moves using the Djikstra search algorithm, the compiled level has its steps too
 		else if (_g == Pink)
 		{
-			std::unordered_map<CSquareGrid::Location, CSquareGrid::Location> came_from;
-			std::unordered_map<CSquareGrid::Location, int> cost_so_far;
-			Grid.DijkstraSearch(Grid, Position(), Pacman.Position(), came_from, cost_so_far);
-			auto path = Grid.ReconstructPath(Position(), Pacman.Position(), came_from);
-			if (path.size() != 0)
-				Position(path.back());
+			if (!Grid.FollowPath(DijkstraPaths, Position(), target, _next))
+			{
+				std::unordered_map<CSquareGrid::Location, CSquareGrid::Location> came_from;
+				std::unordered_map<CSquareGrid::Location, int> cost_so_far;
+				Grid.DijkstraSearch(Grid, Position(), target, came_from, cost_so_far);
+				auto path = Grid.ReconstructPath(Position(), target, came_from);
+				if (path.size() != 0)
+					_next = path.back();
+			}
 		}
 		// the blue ghost moves using the A* search algorithm
 		else if (_g == Blue)
 		{
 			std::unordered_map<CSquareGrid::Location, CSquareGrid::Location> came_from;
 			std::unordered_map<CSquareGrid::Location, int> cost_so_far;
-			Grid.AStarSearch(Grid, Position(), Pacman.Position(), came_from, cost_so_far);
-			auto path = Grid.ReconstructPath(Position(), Pacman.Position(), came_from);
+			Grid.AStarSearch(Grid, Position(), target, came_from, cost_so_far);
+			auto path = Grid.ReconstructPath(Position(), target, came_from);
 			if (path.size() != 0)
-				Position(path.back());
+				_next = path.back();
 		}
 		// the orange ghost moves using random movements, just for fun
 		else
 		{
-			if (Position() != Pacman.Position())
+			if (Position() != target)
 			{
 				typedef CGridWithWeights::Location Location;
-				auto die = std::bind(std::uniform_int_distribution < > {0, 3}, std::default_random_engine{ std::random_device{}() });
-				int direction = die();
-				auto position = Position();
+				int x, y;
+				std::tie(x, y) = Position();
 				Location next;
-				switch (static_cast<Direction>(direction))
+				switch (static_cast<Direction>(std::uniform_int_distribution < > {0, 3}(world.Random())))
 				{
-				case Left:
-					next = Location{ --std::get<0>(position), std::get<1>(position) };
-					if (Grid.Passable(next))
-						Position(next);
-					break;
-				case Right:
-					next = Location{ ++std::get<0>(position), std::get<1>(position) };
-					if (Grid.Passable(next))
-						Position(next);
-					break;
-				case Up:
-					next = Location{ std::get<0>(position), --std::get<1>(position) };
-					if (Grid.Passable(next))
-						Position(next);
-					break;
-					// Orange
-				default:
-					next = Location{ std::get<0>(position), ++std::get<1>(position) };
-					if (Grid.Passable(next))
-						Position(next);
-					break;
+				case Left:  next = Location{ x - 1, y }; break;
+				case Right: next = Location{ x + 1, y }; break;
+				case Up:    next = Location{ x, y - 1 }; break;
+				default:    next = Location{ x, y + 1 }; break;
 				}
+				if (Grid.InBounds(next) && Grid.Passable(next))
+					_next = next;
 			}
 		}
+
+		Approach();
+	}
+
+	void CGhost::Approach()
+	{
+		int dx = ToFixed(std::get<0>(_next)) - _x;
+		int dy = ToFixed(std::get<1>(_next)) - _y;
+
+		// move one axis at a time without going further than the next tile
+		if (dx != 0)
+			_x += std::max(-_speed, std::min(_speed, dx));
+		else
+			_y += std::max(-_speed, std::min(_speed, dy));
 	}
 
 	void CGhost::Reset()
 	{
 		// reset the initial position of the ghosts
 		if (_g == Red)
-			Position(13.5, 14);
+			Position(ToFixed(13) + FIXED_HALF, ToFixed(14));
 		else if (_g == Pink)
-			Position(11.5, 17);
+			Position(ToFixed(11) + FIXED_HALF, ToFixed(17));
 		else if (_g == Blue)
-			Position(13.5, 17);
+			Position(ToFixed(13) + FIXED_HALF, ToFixed(17));
 		else
-			Position(15.5, 17);
+			Position(ToFixed(15) + FIXED_HALF, ToFixed(17));
+
+		_next = Position();
 	}
 }
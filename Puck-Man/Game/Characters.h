@@ -3,11 +3,29 @@
 #ifndef PUCKMAN_GAME_CHARACTER_H_
 #define PUCKMAN_GAME_CHARACTER_H_
 
+#include <tuple>
+#include "TileBitmap.h"
 #include "../Graphics/Textures.h"
 #include "../Common/Utils.h"
 
+namespace graphicscore
+{
+	class CRenderBackend;
+}
+
 namespace gamecore
 {
+	class CWorld;
+
+	// positions are kept in fixed point, each tile is split in FIXED_ONE steps
+	static const int FIXED_SHIFT = 8;
+	static const int FIXED_ONE = 1 << FIXED_SHIFT;
+	static const int FIXED_HALF = FIXED_ONE >> 1;
+	static const int FIXED_MASK = FIXED_ONE - 1;
+
+	// convert a tile coordinate to fixed point
+	inline int ToFixed(int tile) { return tile << FIXED_SHIFT; }
+
 	const enum Direction
 	{
 		Left = 0,
@@ -29,33 +47,66 @@ namespace gamecore
 	class CCharacter
 	{
 	public:
-		CCharacter(graphicscore::Clipping c) : _c{ c } {};
+		CCharacter(graphicscore::Clipping c) : _c{ c }, _speed{ FIXED_ONE } {};
 		~CCharacter() = default;
 
-		// set position of character
-		void Position(GLfloat x, GLfloat y) { _x = x; _y = y; }
-		void Position(std::tuple<int, int> position) { _x = std::get<0>(position); _y = std::get<1>(position); }
+		// set position of character in fixed point
+		void Position(int x, int y) { _x = x; _y = y; }
+		// place the character on a tile
+		void Position(std::tuple<int, int> position) { _x = ToFixed(std::get<0>(position)); _y = ToFixed(std::get<1>(position)); }
+
+		// get the tile where the character is
+		std::tuple<int, int> Position() { return std::make_tuple(_x >> FIXED_SHIFT, _y >> FIXED_SHIFT); }
 
-		// get position of character
-		std::tuple<int, int> Position() { return std::make_tuple(static_cast<int>(_x), static_cast<int>(_y)); }
+		// check if the character is exactly on a tile and not moving between two of them
+		bool Aligned() { return ((_x | _y) & FIXED_MASK) == 0; }
 
-		// set clipping information
+		// get the tile that holds most of the body of the character, now and on the previous tick
+		std::tuple<int, int> Cell() { return NearestTile(_x, _y); }
+		std::tuple<int, int> PreviousCell() { return NearestTile(_px, _py); }
+
+		// get/set the fixed point steps that the character moves on each tick, up to a whole tile
+		int Speed() { return _speed; }
+		void Speed(int speed) { _speed = speed; }
+
+		// get/set clipping information
+		graphicscore::Clipping Clipping() { return _c; }
 		void Clipping(graphicscore::Clipping c) { _c = c; }
 
+		// keep the current position as the one of the previous tick
+		void Settle() { _px = _x; _py = _y; }
+
 		// init the character
 		virtual bool Init() = 0;
 
-		// render the character on screen
-		virtual void Render();
+		// render the character through a backend, alpha is the fraction of the tick elapsed since
+		// its last move and places the character between its previous and current positions
+		virtual void Render(graphicscore::CRenderBackend& backend, GLfloat alpha = 1.f);
+		// get the screen position of the upper left corner of the sprite, alpha works like on Render
+		void SpritePosition(GLfloat alpha, GLfloat& x, GLfloat& y);
+
+		// mark the tiles covered by the sprite anywhere between its previous and current positions
+		void MarkDirty(CTileBitmap& dirty);
 
-		// move the character depending on the key pressed
-		virtual void Move() = 0;
+		// move the character inside of the given world
+		virtual void Move(CWorld& world) = 0;
 
 	protected:
-		// center position of the character
-		GLfloat _x, _y;
+		// position of the character in fixed point
+		int _x, _y;
+		// position of the character on the previous tick
+		int _px, _py;
 		// clipping information to draw sprite
 		graphicscore::Clipping _c;
+		// fixed point steps moved on each tick
+		int _speed;
+
+	private:
+		// the right half of the last column belongs to the first one through the wrap zone
+		static std::tuple<int, int> NearestTile(int x, int y)
+		{
+			return std::make_tuple(((x + FIXED_HALF) >> FIXED_SHIFT) % SCREEN_WIDTH_TILES, (y + FIXED_HALF) >> FIXED_SHIFT);
+		}
 	};
 
 	/*
@@ -70,13 +121,15 @@ namespace gamecore
 
 		/* virtual methods */
 		// init Pacman location
-		bool Init() { Position(13.5, 26); return true; }
+		bool Init() { Position(ToFixed(13) + FIXED_HALF, ToFixed(26)); d = Left; return true; }
 
 		// move Pacman in the current facing direction
-		void Move();
+		void Move(CWorld& world);
 
 		// change the direction at which Pacman is facing
 		void ChangeDirection(Direction dir) { d = dir; }
+		// get the direction at which Pacman is facing
+		Direction Facing() { return d; }
 
 	private:
 		// current facing direction
@@ -97,12 +150,17 @@ namespace gamecore
 		bool Init();
 
 		// move a Ghost to chase Pacman
-		void Move();
+		void Move(CWorld& world);
 
 		void Reset();
 
 	private:
 		Ghost _g;
+		// tile the ghost is moving to
+		std::tuple<int, int> _next;
+
+		// move the ghost towards the next tile
+		void Approach();
 	};
 }
 
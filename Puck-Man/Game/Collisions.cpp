@@ -0,0 +1,64 @@
+#include "Collisions.h"
+
+namespace gamecore
+{
+	void CCollisionGrid::Begin()
+	{
+		// the stage tags only need to be cleared when the counter wraps around
+		if (++_stage == 0)
+		{
+			Clear();
+			_stage = 1;
+		}
+	}
+
+	void CCollisionGrid::AddGhost(unsigned int ghost, Location from, Location to)
+	{
+		unsigned int bit = 1u << ghost;
+		int destination = Index(to);
+
+		_destinations[ghost] = destination;
+		At(destination).occupants |= bit;
+		if (from != to)
+			At(Index(from)).leaving |= bit;
+	}
+
+	unsigned int CCollisionGrid::Test(Location from, Location to)
+	{
+		int origin = Index(from);
+		int destination = Index(to);
+
+		// ghosts that end the tick on the same tile
+		unsigned int caught = At(destination).occupants;
+
+		// ghosts that went in the opposite direction through the same tiles
+		if (origin != destination)
+		{
+			for (unsigned int leaving = At(destination).leaving; leaving != 0; leaving &= leaving - 1)
+			{
+				unsigned int ghost = 0;
+				while (((leaving >> ghost) & 1) == 0)
+					++ghost;
+				if (_destinations[ghost] == origin)
+					caught |= 1u << ghost;
+			}
+		}
+
+		return caught;
+	}
+
+	void CCollisionGrid::Clear()
+	{
+		for (auto& cell : _cells)
+			cell = Cell{ 0, 0, 0 };
+		_destinations.fill(-1);
+	}
+
+	CCollisionGrid::Cell& CCollisionGrid::At(int index)
+	{
+		Cell& cell = _cells[index];
+		if (cell.stage != _stage)
+			cell = Cell{ _stage, 0, 0 };
+		return cell;
+	}
+}
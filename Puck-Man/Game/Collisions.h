@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_COLLISIONS_H_
+#define PUCKMAN_GAME_COLLISIONS_H_
+
+#include <array>
+#include <tuple>
+#include "../Common/Utils.h"
+
+namespace gamecore
+{
+	/*
+	*  Collision grid class, holds the ghosts found on each tile during the collision stage of a tick
+	*
+	*  the cells are tagged with the stage that wrote them, so starting a stage doesn't need to clear
+	*  the grid and the cost of a stage only depends on the number of characters
+	*/
+	class CCollisionGrid
+	{
+	public:
+		typedef std::tuple<int, int> Location;
+
+		// maximum number of ghosts on a single stage
+		static const unsigned int MAX_GHOSTS = 32;
+
+		CCollisionGrid() : _stage{ 0 } { Clear(); }
+		~CCollisionGrid() = default;
+
+		// start a new collision stage, forgetting the ghosts of the previous one
+		void Begin();
+
+		// add a ghost that has moved between two tiles during the tick
+		void AddGhost(unsigned int ghost, Location from, Location to);
+
+		// get the mask of the ghosts that have caught a Pacman that moved between two tiles,
+		// either ending on the same tile or crossing each other on the way
+		unsigned int Test(Location from, Location to);
+
+	private:
+		struct Cell
+		{
+			// stage that wrote the cell, the masks of older stages are not valid
+			unsigned int stage;
+			// ghosts that end the tick on the tile
+			unsigned int occupants;
+			// ghosts that start the tick on the tile and leave it
+			unsigned int leaving;
+		};
+
+		std::array<Cell, SCREEN_WIDTH_TILES * SCREEN_HEIGHT_TILES> _cells;
+		// tile where each ghost of the stage ends the tick
+		std::array<int, MAX_GHOSTS> _destinations;
+		unsigned int _stage;
+
+		// reset every cell of the grid
+		void Clear();
+
+		// get the cell of a tile, preparing it for the current stage
+		Cell& At(int index);
+
+		inline int Index(Location l) { return std::get<1>(l) * SCREEN_WIDTH_TILES + std::get<0>(l); }
+	};
+}
+
+#endif // PUCKMAN_GAME_COLLISIONS_H_
@@ -0,0 +1,55 @@
+#include "Events.h"
+
+namespace gamecore
+{
+	CEventQueue::CEventQueue() : _head{ 0 }, _consumers{ 0 }, _dropped{ 0 }
+	{
+		for (auto& tail : _tails)
+			tail.store(0, std::memory_order_relaxed);
+	}
+
+	bool CEventQueue::Push(const GameEvent& event)
+	{
+		unsigned long long head = _head.load(std::memory_order_relaxed);
+
+		// check that every consumer has released the slot that is going to be written
+		unsigned int consumers = _consumers.load(std::memory_order_acquire);
+		for (int i = 0; consumers != 0; ++i, consumers >>= 1)
+		{
+			if ((consumers & 1) != 0 && head - _tails[i].load(std::memory_order_acquire) >= CAPACITY)
+			{
+				++_dropped;
+				return false;
+			}
+		}
+
+		_events[head & (CAPACITY - 1)] = event;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	int CEventQueue::Subscribe()
+	{
+		unsigned int consumers = _consumers.load(std::memory_order_relaxed);
+		for (int i = 0; i < MAX_CONSUMERS; ++i)
+		{
+			unsigned int bit = 1u << i;
+			if ((consumers & bit) != 0)
+				continue;
+
+			// the position must be valid before the producer starts checking it
+			_tails[i].store(_head.load(std::memory_order_acquire), std::memory_order_release);
+			if ((_consumers.fetch_or(bit, std::memory_order_acq_rel) & bit) == 0)
+				return i;
+
+			// another consumer took the slot in the meantime
+			consumers = _consumers.load(std::memory_order_relaxed);
+		}
+		return -1;
+	}
+
+	void CEventQueue::Unsubscribe(int consumer)
+	{
+		_consumers.fetch_and(~(1u << consumer), std::memory_order_acq_rel);
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_EVENTS_H_
+#define PUCKMAN_GAME_EVENTS_H_
+
+#include <array>
+#include <atomic>
+
+namespace gamecore
+{
+	// events raised by the simulation
+	const enum EventType
+	{
+		PillEaten = 0,
+		EnergizerEaten,
+		PacmanCaught,
+		LevelCleared
+	};
+
+	struct GameEvent
+	{
+		EventType type;
+		// tile where the event happened
+		int x, y;
+		// points given by the event
+		int points;
+		// tick of the world when the event happened
+		unsigned int tick;
+	};
+
+	/*
+	*  Event queue class, ring buffer written by the simulation and read by several consumers
+	*
+	*  there's a single producer and each consumer has its own read position, so nobody takes a lock
+	*  or allocates memory; when the slowest consumer falls a whole ring behind, new events are
+	*  dropped instead of stalling the simulation
+	*/
+	class CEventQueue
+	{
+	public:
+		// number of events held by the ring, a power of two
+		static const unsigned int CAPACITY = 256;
+		// maximum number of consumers reading at the same time
+		static const int MAX_CONSUMERS = 4;
+
+		CEventQueue();
+		~CEventQueue() = default;
+
+		// the events belong to the queue they were pushed to, a copy starts with an empty queue
+		// and assigning a queue keeps the events and consumers of the destination
+		CEventQueue(const CEventQueue&) : CEventQueue() {}
+		CEventQueue& operator=(const CEventQueue&) { return *this; }
+
+		/* producer */
+		// add an event to the queue, returns false if it was dropped
+		bool Push(const GameEvent& event);
+		// number of events dropped because a consumer was full
+		unsigned long long Dropped() { return _dropped; }
+
+		/* consumers */
+		// register a new consumer that gets the events pushed from now on, returns -1 if there's no room
+		int Subscribe();
+		// remove a consumer
+		void Unsubscribe(int consumer);
+
+		// call the handler with every event that the consumer hasn't seen, returns the number of events
+		template<typename Handler>
+		unsigned int Drain(int consumer, Handler handler)
+		{
+			unsigned long long tail = _tails[consumer].load(std::memory_order_relaxed);
+			unsigned long long head = _head.load(std::memory_order_acquire);
+			unsigned int count = static_cast<unsigned int>(head - tail);
+
+			// the producer doesn't write over a slot until the consumer releases it
+			for (; tail != head; ++tail)
+				handler(_events[tail & (CAPACITY - 1)]);
+
+			_tails[consumer].store(tail, std::memory_order_release);
+			return count;
+		}
+
+	private:
+		std::array<GameEvent, CAPACITY> _events;
+
+		// sequence number of the next event to write
+		std::atomic<unsigned long long> _head;
+		// sequence number of the next event to read by each consumer
+		std::array<std::atomic<unsigned long long>, MAX_CONSUMERS> _tails;
+		// mask of the registered consumers
+		std::atomic<unsigned int> _consumers;
+
+		// only touched by the producer
+		unsigned long long _dropped;
+	};
+}
+
+#endif // PUCKMAN_GAME_EVENTS_H_
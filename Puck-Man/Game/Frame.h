@@ -0,0 +1,51 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_FRAME_H_
+#define PUCKMAN_GAME_FRAME_H_
+
+#include <array>
+#include <chrono>
+#include "Characters.h"
+#include "TileBitmap.h"
+#include "World.h"
+#include "../Common/Utils.h"
+
+namespace gamecore
+{
+	// ticks whose changed tiles travel with each frame, a painter that falls further behind paints everything
+	static const unsigned int DIRTY_HISTORY = 8;
+
+	/*
+	*  Frame struct, copy of everything needed to paint the game after a tick, it's written by the
+	*  simulation thread and read by the render thread so the characters are copies and not references
+	*/
+	struct GameFrame
+	{
+		// pills that remain on the world
+		CTileBitmap pills;
+		// characters with their current and previous positions
+		CPacman pacman;
+		std::array<CGhost, Ghost_Size> ghosts;
+
+		int score;
+		int highScore;
+
+		// tiles changed on each of the last ticks, indexed by tick % DIRTY_HISTORY
+		std::array<CTileBitmap, DIRTY_HISTORY> dirty;
+
+		// number of the tick since the game started and the time when it was simulated, used to
+		// interpolate the characters
+		unsigned int tick;
+		std::chrono::steady_clock::time_point time;
+
+		// copy the pills and the characters of a world, the rest is filled by whoever owns the frame
+		void Capture(CWorld& world)
+		{
+			pills = world.Pills();
+			pacman = world.Pacman();
+			ghosts = world.Ghosts();
+		}
+	};
+}
+
+#endif // PUCKMAN_GAME_FRAME_H_
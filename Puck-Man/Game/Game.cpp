@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Game.h"
 #include "../Common/Utils.h"
 #include "../Graphics/Textures.h"
@@ -10,7 +11,36 @@ namespace gamecore
 		return game;
 	}
 
-	bool CGame::Init()
+	bool CGame::Init(bool graphics)
+	{
+		if (graphics && !InitGraphics())
+			return false;
+
+		// initialize the scenario information
+		if (!_scenario.Init(true, _level))
+			return false;
+
+		if (graphics)
+		{
+			// paint the walls on their own layer
+			_scenario.InitMapLayer();
+			if (!_scenario.Data().UploadLayer())
+				return false;
+		}
+
+		// initialize the world with Pacman and the ghosts
+		_world.Init(_scenario);
+
+		// keep the score from the events of the world
+		_consumer = _world.Events().Subscribe();
+
+		// leave a frame ready for the first paint
+		Publish(std::chrono::steady_clock::now());
+
+		return true;
+	}
+
+	bool CGame::InitGraphics()
 	{
 		// set the clear color to black
 		glClearColor(0.f, 0.f, 0.f, 0.f);
@@ -53,20 +83,128 @@ namespace gamecore
 		}
 
 		// initialize the main texture and clipping information
-		_scenario.Data().Init();
+		if (!_scenario.Data().Init())
+			return false;
 
-		// initialize the scenario information
-		_scenario.Init();
+		return true;
+	}
 
-		// initialize Pacman
-		_pacman.Init();
+	void CGame::Start()
+	{
+		if (_running.exchange(true))
+			return;
+		_simulation = std::thread(&CGame::Simulate, this);
+	}
 
-		// create a ghost of each color
-		_ghosts = { { Ghost{ Red }, Ghost{ Pink }, Ghost{ Blue }, Ghost{ Orange } } };
-		// initialize the ghosts
-		for (auto& ghost : _ghosts)
-			ghost.Init();
+	void CGame::Stop()
+	{
+		if (!_running.exchange(false))
+			return;
+		_simulation.join();
+	}
 
-		return true;
+	/*
+	*  run the ticks of the world at a fixed rate, independently of the frames painted on screen
+	*/
+	void CGame::Simulate()
+	{
+		using std::chrono::steady_clock;
+
+		_scheduler.Start();
+		auto report = _scheduler.Deadline() + std::chrono::seconds(1);
+		while (_running)
+		{
+			_scheduler.Wait();
+
+			// the time doesn't run for the game while it's paused, the cadence goes on
+			if (_state == GamePaused)
+				continue;
+
+			auto start = steady_clock::now();
+			Tick();
+			ProcessEvents();
+			Publish(_scheduler.Deadline());
+			auto now = steady_clock::now();
+			_tickStats.Add(now - start);
+
+			if (now >= report)
+			{
+#if DEBUG_CONSOLE
+				std::cout << "Ticks: " << _tickStats << ", dropped " << _scheduler.Dropped() << ", jitter " << _scheduler.Jitter();
+				if (_autopiloted)
+					std::cout << ", autopilot " << static_cast<long long>(_autopilot.RolloutsPerSecond()) << " rollouts/s";
+				std::cout << std::endl;
+#endif
+				_tickStats.Clear();
+				_scheduler.ClearStats();
+				report = now + std::chrono::seconds(1);
+			}
+		}
+	}
+
+	/*
+	*  advance the game one tick
+	*/
+	void CGame::Tick()
+	{
+		// take the requests of the input
+		if (_resetGhosts.exchange(false))
+			_world.ResetGhosts();
+		int steer = _steer.exchange(NO_STEER);
+		if (steer != NO_STEER)
+			_world.Pacman().ChangeDirection(static_cast<Direction>(steer));
+
+		// let the autopilot choose the direction of Pacman
+		if (_autopiloted)
+			_world.Pacman().ChangeDirection(_autopilot.Choose(_world));
+
+		// move Pacman and the Ghosts on the scenario, the level starts again when
+		// Pacman is caught or has eaten all the pills
+		auto result = _world.Step();
+		if (result.caught || result.cleared)
+			_world.Reset();
+		++_tick;
+	}
+
+	void CGame::Publish(std::chrono::steady_clock::time_point time)
+	{
+		GameFrame& frame = _frames.Back();
+		frame.Capture(_world);
+		frame.score = _score;
+		frame.highScore = _highScore;
+		frame.tick = _tick;
+		frame.time = time;
+
+		// hand the changed tiles to the painter and start collecting the ones of the next tick
+		_dirty[_tick % DIRTY_HISTORY] = _world.Dirty();
+		_world.Dirty().Clear();
+		frame.dirty = _dirty;
+		_frames.Publish();
+	}
+
+	void CGame::ProcessEvents()
+	{
+		_world.Events().Drain(_consumer, [this](const GameEvent& event)
+		{
+			switch (event.type)
+			{
+			case PillEaten:
+			case EnergizerEaten:
+				_score += event.points;
+				_highScore = std::max(_highScore, _score);
+				break;
+			case PacmanCaught:
+#if DEBUG_CONSOLE
+				std::cout << "Pacman caught at tick " << event.tick << ", score " << _score << std::endl;
+#endif
+				_score = 0;
+				break;
+			case LevelCleared:
+#if DEBUG_CONSOLE
+				std::cout << "Level cleared at tick " << event.tick << ", score " << _score << std::endl;
+#endif
+				break;
+			}
+		});
 	}
 }
@@ -5,8 +5,17 @@
 
 #pragma comment(lib,"glut32")
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include "Autopilot.h"
 #include "Characters.h"
+#include "Frame.h"
 #include "Scenario.h"
+#include "World.h"
+#include "../Common/TickScheduler.h"
+#include "../Common/TimingStats.h"
+#include "../Common/TripleBuffer.h"
 #include "../GLUT/glut.h"
 
 namespace gamecore
@@ -19,32 +28,63 @@ namespace gamecore
 		// method to get an instance of the CGraphics class
 		static CGame& Instance();
 
-		// method to initialize the game
-		bool Init();
+		// method to initialize the game, without graphics only the scenario and the world are loaded
+		// for the frontends that don't use OpenGL
+		bool Init(bool graphics = true);
+
+		// start/stop the thread that simulates the world, the rest of the methods are safe
+		// to call from any other thread while it runs
+		void Start();
+		void Stop();
 
 		// get/set the state of the game
 		GameState State() { return _state; }
 		void State(const GameState state) { _state = state; }
 
-		// get the scenario for the current game
+		// get the scenario for the current game, it doesn't change after the initialization
 		CScenario& Scenario() { return _scenario; }
-		// get the Pacman character of the current game
-		CPacman& Pacman() { return _pacman; }
-		// get the Ghosts from the current game
-		std::array<CGhost, Ghost_Size>& Ghosts() { return _ghosts; }
+
+		// get/set the description of the level loaded by Init
+		const std::string& Level() { return _level; }
+		void Level(const std::string& level) { _level = level; }
+
+		// ask the simulation to turn Pacman on the next tick
+		void Steer(Direction direction) { _steer = direction; }
+		// ask the simulation to send the Ghosts back home on the next tick
+		void ResetGhosts() { _resetGhosts = true; }
+
+		// get/set if Pacman is driven by the autopilot instead of the keyboard
+		bool Autopiloted() { return _autopiloted; }
+		void Autopiloted(bool autopiloted) { _autopiloted = autopiloted; }
+
+		// take the latest frame published by the simulation, it stays valid until the next call
+		GameFrame& Frame() { _frames.Acquire(); return _frames.Front(); }
 
 	private:
 		// disable the creation of objects outside of this class
-		CGame::CGame() : _state(GameRunning) {}
-		// use default constructor (no parameters)
-		~CGame() = default;
+		CGame::CGame() : _level(LEVEL_MAP), _state(GameRunning), _steer(NO_STEER), _resetGhosts(false), _autopiloted(false), _running(false), _tick(0), _score(0), _highScore(0), _consumer(-1),
+			_scheduler(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / TICKS_PER_SECOND, commoncore::CatchUp, MAX_CATCH_UP_TICKS) {}
+		// stop the simulation before the world is destroyed
+		~CGame() { Stop(); }
 
-		// object for the scenario
+		// method to set up OpenGL, DevIL and the textures
+		bool InitGraphics();
+		// method executed by the simulation thread
+		void Simulate();
+		// advance the world one tick
+		void Tick();
+		// consume the events raised by the world since the last call
+		void ProcessEvents();
+		// copy the state of the world on the next frame
+		void Publish(std::chrono::steady_clock::time_point time);
+
+		// description of the level and the scenario built from it
+		std::string _level;
 		CScenario _scenario;
-		// Pacman object
-		CPacman _pacman;
-		// Ghosts array
-		std::array<CGhost, Ghost_Size> _ghosts;
+		// world with the characters and the elements of the current game
+		CWorld _world;
+		// Monte Carlo tree search controller for Pacman
+		CAutopilot _autopilot;
 
 		/* remove these features to avoid deletion of this class' object */
 		// remove the copy constructor
@@ -54,7 +94,32 @@ namespace gamecore
 		// remove the delete operator
 		void operator delete(void*) = delete;
 
-		GameState _state;
+		// frames passed from the simulation to the render thread
+		commoncore::CTripleBuffer<GameFrame> _frames;
+		// thread that simulates the world, it owns the world, the autopilot and the score
+		std::thread _simulation;
+
+		// requests from the input, taken by the simulation on the next tick
+		static const int NO_STEER = -1;
+		std::atomic<GameState> _state;
+		std::atomic<int> _steer;
+		std::atomic<bool> _resetGhosts;
+		std::atomic<bool> _autopiloted;
+		std::atomic<bool> _running;
+
+		// ticks simulated since the game started and the tiles changed on the last ones
+		unsigned int _tick;
+		std::array<CTileBitmap, DIRTY_HISTORY> _dirty;
+
+		int _score;
+		int _highScore;
+		// consumer of the world events that keeps the score
+		int _consumer;
+
+		// wakes the simulation up on the deadline of each tick
+		commoncore::CTickScheduler _scheduler;
+		// duration of the ticks on the last second
+		commoncore::CTimingStats _tickStats;
 	};
 }
 
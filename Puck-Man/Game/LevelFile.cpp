@@ -0,0 +1,264 @@
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "LevelFile.h"
+#include "Scenario.h"
+
+namespace gamecore
+{
+	namespace
+	{
+		typedef CSquareGrid::Location Location;
+
+		const size_t BITMAP_SIZE = CTileBitmap::WORDS * sizeof(uint64_t);
+
+		inline size_t Align(size_t offset, size_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+		// check that the bits past the last tile of a bitmap are clear
+		inline bool Trimmed(const uint64_t* words)
+		{
+			return CTileBitmap::TILES % 64 == 0 || (words[CTileBitmap::WORDS - 1] >> (CTileBitmap::TILES % 64)) == 0;
+		}
+
+		inline int Index(Location location) { return std::get<1>(location) * SCREEN_WIDTH_TILES + std::get<0>(location); }
+
+		// fill the steps from a tile to every other with the tiles each one was reached from, the first
+		// tile of the path to a goal is shared with the tiles that lead to it so each path is walked once
+		void AddSteps(uint8_t* steps, Location start, std::unordered_map<Location, Location>& came_from)
+		{
+			std::array<int, CTileBitmap::TILES> hops;
+			hops.fill(-1);
+			std::vector<int> chain;
+			for (auto& entry : came_from)
+			{
+				Location location = entry.first;
+				chain.clear();
+				while (location != start && hops[Index(location)] < 0)
+				{
+					Location previous = came_from[location];
+					if (previous == start)
+					{
+						hops[Index(location)] = Index(location);
+						break;
+					}
+					chain.push_back(Index(location));
+					location = previous;
+				}
+				for (int tile : chain)
+					hops[tile] = hops[Index(location)];
+			}
+
+			int x = std::get<0>(start), y = std::get<1>(start);
+			for (int goal = 0; goal < CTileBitmap::TILES; ++goal)
+			{
+				// ReconstructPath leaves out the goal and the start, the step is the tile before the start
+				int hop = hops[goal];
+				if (goal == Index(start))
+					steps[goal] = PATH_STAY;
+				else if (hop < 0 || hop == goal)
+					steps[goal] = PATH_NONE;
+				else
+				{
+					int dx = hop % SCREEN_WIDTH_TILES - x, dy = hop / SCREEN_WIDTH_TILES - y;
+					for (uint8_t direction = 0; direction < 4; ++direction)
+						if (STEP_X[direction] == dx && STEP_Y[direction] == dy)
+							steps[goal] = direction;
+				}
+			}
+		}
+	}
+
+	bool CLevelFile::Open(const std::string& filename)
+	{
+		_data = nullptr;
+		_header = nullptr;
+		_error.clear();
+
+		// the tables are read here and there as the ghosts move, nothing is read ahead
+		if (!_file.Open(filename, commoncore::RandomAccess))
+			return Fail(filename, "unable to open the file");
+		if (_file.Size() < sizeof(LevelHeader))
+			return Fail(filename, "the file is too short");
+
+		_data = _file.Data();
+		_header = reinterpret_cast<const LevelHeader*>(_data);
+		if (_header->magic != LEVEL_MAGIC)
+			return Fail(filename, "it's not a compiled level");
+		if (_header->version != LEVEL_VERSION)
+			return Fail(filename, "the file has version " + std::to_string(_header->version) + " instead of " + std::to_string(LEVEL_VERSION));
+		if (_header->width != SCREEN_WIDTH_TILES || _header->height != SCREEN_HEIGHT_TILES || _header->clippings != graphicscore::Clipping_Size)
+			return Fail(filename, "the level was compiled for another screen or sprite sheet");
+
+		if (!Section(_header->wallsOffset, BITMAP_SIZE, sizeof(uint64_t)) || !Section(_header->obstaclesOffset, BITMAP_SIZE, sizeof(uint64_t)) ||
+			!Section(_header->pillsOffset, BITMAP_SIZE, sizeof(uint64_t)) || !Section(_header->energizersOffset, BITMAP_SIZE, sizeof(uint64_t)) ||
+			!Section(_header->zonesOffset, CTileBitmap::TILES, 1) || !Section(_header->tunnelsOffset, SCREEN_HEIGHT_TILES, 1) ||
+			!Section(_header->spritesOffset, _header->sprites * sizeof(LevelSprite), sizeof(uint16_t)) ||
+			(_header->paths != 0 && !Section(_header->pathsOffset, PathSearch_Size * PATHS_SIZE, 1)))
+			return Fail(filename, "a section is out of the file");
+
+		// the small sections are checked so the scenario can index with them, the tables are not
+		// read until the steps are followed
+		if (!Trimmed(Walls()) || !Trimmed(Obstacles()) || !Trimmed(Pills()) || !Trimmed(Energizers()))
+			return Fail(filename, "a bitmap has tiles out of the screen");
+		for (int tile = 0; tile < CTileBitmap::TILES; ++tile)
+			if (Zones()[tile] >= LevelZone_Size)
+				return Fail(filename, "the tile " + std::to_string(tile) + " has an unknown zone");
+		if (_header->firstPill > _header->sprites)
+			return Fail(filename, "the first pill is out of the sprites");
+		for (size_t i = 0; i < SpriteCount(); ++i)
+			if (Sprites()[i].tile >= CTileBitmap::TILES || Sprites()[i].clip >= graphicscore::Clipping_Size)
+				return Fail(filename, "the sprite " + std::to_string(i) + " is out of range");
+
+		return true;
+	}
+
+	bool CLevelFile::Compile(const std::string& map)
+	{
+		// the description of the level fills the scenario and the navigation grid
+		CScenario scenario;
+		if (!scenario.Init(false, map))
+			return false;
+		auto& grid = CGridWithWeights::Instance();
+
+		// the level is stale as soon as its description changes
+		uint64_t source;
+		if (!Fingerprint(map, source))
+			return false;
+
+		// the sections follow the header, each one aligned to its words
+		LevelHeader header;
+		std::memset(&header, 0, sizeof(header));
+		header.magic = LEVEL_MAGIC;
+		header.version = LEVEL_VERSION;
+		header.width = SCREEN_WIDTH_TILES;
+		header.height = SCREEN_HEIGHT_TILES;
+		header.clippings = graphicscore::Clipping_Size;
+		header.paths = 1;
+		header.sprites = static_cast<uint32_t>(scenario.Sprites().size());
+		header.firstPill = static_cast<uint32_t>(scenario.FirstPill());
+		header.source = source;
+
+		size_t size = Align(sizeof(LevelHeader), sizeof(uint64_t));
+		uint32_t* offsets[] = { &header.wallsOffset, &header.obstaclesOffset, &header.pillsOffset, &header.energizersOffset };
+		for (uint32_t* offset : offsets)
+		{
+			*offset = static_cast<uint32_t>(size);
+			size += BITMAP_SIZE;
+		}
+		header.zonesOffset = static_cast<uint32_t>(size);
+		size += CTileBitmap::TILES;
+		header.tunnelsOffset = static_cast<uint32_t>(size);
+		size = Align(size + SCREEN_HEIGHT_TILES, sizeof(uint16_t));
+		header.spritesOffset = static_cast<uint32_t>(size);
+		size = Align(size + header.sprites * sizeof(LevelSprite), sizeof(uint64_t));
+		header.pathsOffset = static_cast<uint32_t>(size);
+		size += PathSearch_Size * PATHS_SIZE;
+
+		std::vector<char> data(size, 0);
+		std::memcpy(data.data(), &header, sizeof(header));
+
+		CTileBitmap walls, energizers;
+		for (int y = 0; y < SCREEN_HEIGHT_TILES; ++y)
+		{
+			for (int x = 0; x < SCREEN_WIDTH_TILES; ++x)
+			{
+				if (scenario.ElementsMatrix()[x][y] == Wall)
+					walls.Set(x, y);
+				else if (scenario.ElementsMatrix()[x][y] == Energizer)
+					energizers.Set(x, y);
+			}
+		}
+		std::memcpy(&data[header.wallsOffset], walls.Words().data(), BITMAP_SIZE);
+		std::memcpy(&data[header.obstaclesOffset], grid._walls.Words().data(), BITMAP_SIZE);
+		std::memcpy(&data[header.pillsOffset], scenario.Pills().Words().data(), BITMAP_SIZE);
+		std::memcpy(&data[header.energizersOffset], energizers.Words().data(), BITMAP_SIZE);
+
+		uint8_t* zones = reinterpret_cast<uint8_t*>(&data[header.zonesOffset]);
+		for (auto location : grid.Ground())
+			zones[Index(location)] = GroundZone;
+		for (auto location : grid.Grass())
+			zones[Index(location)] = GrassZone;
+		for (auto location : grid.Water())
+			zones[Index(location)] = WaterZone;
+
+		for (int y = 0; y < SCREEN_HEIGHT_TILES; ++y)
+			data[header.tunnelsOffset + y] = scenario.Tunnel(y) ? 1 : 0;
+
+		LevelSprite* sprites = reinterpret_cast<LevelSprite*>(&data[header.spritesOffset]);
+		for (size_t i = 0; i < scenario.Sprites().size(); ++i)
+		{
+			sprites[i].tile = static_cast<uint16_t>(scenario.Sprites()[i].tile);
+			sprites[i].clip = static_cast<uint16_t>(scenario.Sprites()[i].clip);
+		}
+
+		// the searches run from every tile until the whole grid is reached, a goal out of the grid is
+		// never found; the paths to every goal are the same that a search stopped on it gives
+		uint8_t* paths = reinterpret_cast<uint8_t*>(&data[header.pathsOffset]);
+		const Location nowhere{ -1, -1 };
+		for (int tile = 0; tile < CTileBitmap::TILES; ++tile)
+		{
+			Location start{ tile % SCREEN_WIDTH_TILES, tile / SCREEN_WIDTH_TILES };
+
+			auto came_from = grid.BreadthFirstSearch(grid, start, nowhere);
+			AddSteps(paths + BreadthFirstPaths * PATHS_SIZE + tile * CTileBitmap::TILES, start, came_from);
+
+			std::unordered_map<Location, int> cost_so_far;
+			came_from.clear();
+			grid.DijkstraSearch(grid, start, nowhere, came_from, cost_so_far);
+			AddSteps(paths + DijkstraPaths * PATHS_SIZE + tile * CTileBitmap::TILES, start, came_from);
+		}
+
+		std::string filename = CompiledName(map);
+		std::ofstream output{ filename, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc };
+		output.write(data.data(), data.size());
+		output.close();
+		if (!output)
+		{
+#if DEBUG_CONSOLE
+			std::cout << "ERROR: Unable to write the compiled level: " << filename << std::endl;
+#endif
+			return false;
+		}
+
+#if DEBUG_CONSOLE
+		std::cout << "Level compiled to " << filename << ": " << header.sprites << " sprites and " << data.size() / 1024 << " KB" << std::endl;
+#endif
+		return true;
+	}
+
+	std::string CLevelFile::CompiledName(const std::string& map)
+	{
+		// the extension is replaced, a dot on the directories doesn't start one
+		size_t dot = map.find_last_of('.');
+		size_t slash = map.find_last_of("/\\");
+		if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+			dot = map.size();
+		return map.substr(0, dot) + ".bin";
+	}
+
+	bool CLevelFile::Fingerprint(const std::string& filename, uint64_t& hash)
+	{
+		commoncore::CMappedFile file;
+		if (!file.Open(filename))
+			return false;
+
+		hash = 14695981039346656037ull;
+		for (size_t i = 0; i < file.Size(); ++i)
+			hash = (hash ^ static_cast<uint8_t>(file.Data()[i])) * 1099511628211ull;
+		return true;
+	}
+
+	bool CLevelFile::Section(uint32_t offset, size_t size, size_t alignment)
+	{
+		return offset % alignment == 0 && offset <= _file.Size() && size <= _file.Size() - offset;
+	}
+
+	bool CLevelFile::Fail(const std::string& filename, const std::string& message)
+	{
+		_file.Close();
+		_data = nullptr;
+		_header = nullptr;
+		_error = filename + ": " + message;
+		return false;
+	}
+}
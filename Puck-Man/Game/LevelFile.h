@@ -0,0 +1,160 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_LEVELFILE_H_
+#define PUCKMAN_GAME_LEVELFILE_H_
+
+#include <cstdint>
+#include <string>
+#include "TileBitmap.h"
+#include "../Common/MappedFile.h"
+#include "../Common/Utils.h"
+
+namespace gamecore
+{
+	// description of the level loaded when no other is given; its compiled level goes next to it, with
+	// the extension .bin, and it's loaded instead of the description while they match
+	const char LEVEL_MAP[] = "Scenarios/Level.txt";
+
+	// "PMLV" read as a little endian word and the version of the layout below, a file with another
+	// version (or written on a big endian machine) is left aside
+	const uint32_t LEVEL_MAGIC = 0x564c4d50;
+	const uint32_t LEVEL_VERSION = 3;
+
+	// special zones of the navigation grid, stored with a byte per tile
+	const enum LevelZone
+	{
+		NoZone = 0,
+		GroundZone,
+		GrassZone,
+		WaterZone,
+		LevelZone_Size
+	};
+
+	// searches that have a table with their steps between every pair of tiles
+	const enum PathSearch
+	{
+		BreadthFirstPaths = 0,
+		DijkstraPaths,
+		PathSearch_Size
+	};
+
+	// a step is the direction of the next tile, or one of these when the search doesn't give one:
+	// the target is on the same tile, or the path is empty (the target is next to the tile or it
+	// can't be reached)
+	const uint8_t PATH_STAY = 4;
+	const uint8_t PATH_NONE = 0xff;
+
+	// offsets to the next tile of each direction, in the order of the directions of the characters
+	// (left, right, up and down)
+	const int STEP_X[] = { -1, 1, 0, 0 };
+	const int STEP_Y[] = { 0, 0, -1, 1 };
+
+	// sprite of the map, by its tile index (y * SCREEN_WIDTH_TILES + x) and clipping
+	struct LevelSprite
+	{
+		uint16_t tile;
+		uint16_t clip;
+	};
+
+	// header at the start of the file, the sections are found at their offsets from the start
+	struct LevelHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		// the level only fits a screen and a sprite sheet with the same sizes
+		uint16_t width, height;
+		uint16_t clippings;
+		// 1 when the tables of steps are on the file
+		uint16_t paths;
+		// number of sprites, the walls first and then the pills
+		uint32_t sprites;
+		uint32_t firstPill;
+		// FNV-1a hash of the bytes of the description the level was compiled from
+		uint64_t source;
+		// bitmaps with the words of CTileBitmap: the walls of the scenario, the tiles that the navigation
+		// grid can't pass and the pills of each kind
+		uint32_t wallsOffset;
+		uint32_t obstaclesOffset;
+		uint32_t pillsOffset;
+		uint32_t energizersOffset;
+		// LevelZone of each tile
+		uint32_t zonesOffset;
+		// 1 for the rows whose first and last tiles lead to each other
+		uint32_t tunnelsOffset;
+		// LevelSprite records
+		uint32_t spritesOffset;
+		// a table per search with the step from every tile to every other, by from * TILES + to
+		uint32_t pathsOffset;
+	};
+
+	/*
+	*  Level file class, the scenario and its navigation grid compiled to a binary file that is mapped
+	*  on memory and read in place; the tables of steps take most of it and only the pages that the
+	*  ghosts touch are loaded
+	*/
+	class CLevelFile
+	{
+	public:
+		CLevelFile() : _data{ nullptr }, _header{ nullptr } {}
+		~CLevelFile() = default;
+
+		// map a compiled level and check its header and sections, nothing is copied
+		bool Open(const std::string& filename);
+		// load the scenario from a description and compile it with the steps of the searches
+		static bool Compile(const std::string& map = LEVEL_MAP);
+		// file of the compiled level of a description
+		static std::string CompiledName(const std::string& map);
+		// hash of the bytes of a description, false when it can't be read
+		static bool Fingerprint(const std::string& filename, uint64_t& hash);
+
+		// description of the last error
+		const std::string& Error() const { return _error; }
+
+		// hash of the description the level was compiled from
+		uint64_t Source() const { return _header->source; }
+
+		// bitmaps of the level, they point to the mapped file
+		const uint64_t* Walls() const { return At<uint64_t>(_header->wallsOffset); }
+		const uint64_t* Obstacles() const { return At<uint64_t>(_header->obstaclesOffset); }
+		const uint64_t* Pills() const { return At<uint64_t>(_header->pillsOffset); }
+		const uint64_t* Energizers() const { return At<uint64_t>(_header->energizersOffset); }
+		// zone of each tile and the tunnel rows
+		const uint8_t* Zones() const { return At<uint8_t>(_header->zonesOffset); }
+		const uint8_t* Tunnels() const { return At<uint8_t>(_header->tunnelsOffset); }
+
+		// sprites of the map in tile order, the pills start at FirstPill
+		const LevelSprite* Sprites() const { return At<LevelSprite>(_header->spritesOffset); }
+		size_t SpriteCount() const { return _header->sprites; }
+		size_t FirstPill() const { return _header->firstPill; }
+
+		// table of steps of a search, nullptr when the level was compiled without them
+		const uint8_t* Paths(PathSearch search) const
+		{
+			return _header->paths != 0 ? At<uint8_t>(_header->pathsOffset) + search * PATHS_SIZE : nullptr;
+		}
+
+		static const size_t PATHS_SIZE = static_cast<size_t>(CTileBitmap::TILES) * CTileBitmap::TILES;
+
+	private:
+		/* remove these features to keep the pointers on a single mapping */
+		// remove the copy constructor
+		CLevelFile(const CLevelFile& src) = delete;
+		// remove the copy assign operator
+		const CLevelFile& operator=(const CLevelFile& rhs) = delete;
+
+		template<typename Type>
+		const Type* At(uint32_t offset) const { return reinterpret_cast<const Type*>(_data + offset); }
+
+		// check that a section fits on the file
+		bool Section(uint32_t offset, size_t size, size_t alignment);
+		// close the file and describe why it can't be used, returns false to be passed along
+		bool Fail(const std::string& filename, const std::string& message);
+
+		commoncore::CMappedFile _file;
+		const char* _data;
+		const LevelHeader* _header;
+		std::string _error;
+	};
+}
+
+#endif // PUCKMAN_GAME_LEVELFILE_H_
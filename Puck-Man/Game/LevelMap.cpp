@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstring>
+#include "LevelMap.h"
+#include "../Common/MappedFile.h"
+#include "../Graphics/Textures.h"
+
+namespace gamecore
+{
+	namespace
+	{
+		// layers of the description, in the order they are given
+		const enum LevelLayer
+		{
+			TilesLayer = 0,
+			GridLayer,
+			LevelLayer_Size
+		};
+
+		const char* LAYER_NAMES[LevelLayer_Size] = { "[tiles]", "[grid]" };
+
+		// blanks allowed at the end of the lines
+		inline bool IsBlank(char ch) { return ch == ' ' || ch == '\t' || ch == '\r'; }
+	}
+
+	bool CLevelMap::Load(const std::string& filename)
+	{
+		commoncore::CMappedFile file;
+		if (!file.Open(filename))
+		{
+			Clear();
+			_error = filename + ": unable to open the file";
+			return false;
+		}
+		return Parse(file.Data(), file.Size(), filename);
+	}
+
+	bool CLevelMap::Parse(const char* data, size_t size, const std::string& name)
+	{
+		Clear();
+
+		const char* end = data + size;
+		// layer of the rows being read, the header of each layer and the rows read on it
+		int layer = -1;
+		const char* headers[LevelLayer_Size] = { nullptr, nullptr };
+		int rows[LevelLayer_Size] = { 0, 0 };
+		// check that the current layer has all its rows
+		auto finished = [&]()
+		{
+			return layer < 0 || rows[layer] == SCREEN_HEIGHT_TILES ||
+				Fail(name, data, headers[layer], std::string{ "the layer " } + LAYER_NAMES[layer] + " has " + std::to_string(rows[layer]) +
+					" of its " + std::to_string(SCREEN_HEIGHT_TILES) + " rows");
+		};
+
+		for (const char* line = data; line < end; )
+		{
+			const char* next = static_cast<const char*>(std::memchr(line, '\n', end - line));
+			const char* lineEnd = next != nullptr ? next : end;
+			const char* last = lineEnd;
+			while (last != line && IsBlank(last[-1]))
+				--last;
+
+			// the empty lines and the comments are left out
+			if (last == line || *line == ';')
+			{
+			}
+			else if (*line == '[')
+			{
+				if (!finished())
+					return false;
+
+				std::string header{ line, last };
+				layer = static_cast<int>(std::find(LAYER_NAMES, LAYER_NAMES + LevelLayer_Size, header) - LAYER_NAMES);
+				if (layer == LevelLayer_Size)
+					return Fail(name, data, line, "unknown layer " + header);
+				if (headers[layer] != nullptr)
+					return Fail(name, data, line, "the layer " + header + " is given twice");
+				if (layer == GridLayer && headers[TilesLayer] == nullptr)
+					return Fail(name, data, line, "the layer [grid] goes after the layer [tiles]");
+				headers[layer] = line;
+			}
+			else
+			{
+				if (layer < 0)
+					return Fail(name, data, line, "a row out of a layer");
+				if (rows[layer] == SCREEN_HEIGHT_TILES)
+					return Fail(name, data, line, std::string{ "the layer " } + LAYER_NAMES[layer] + " has more than " + std::to_string(SCREEN_HEIGHT_TILES) + " rows");
+				if (*line != '|')
+					return Fail(name, data, line, std::string{ "expected a row between bars, found '" } + *line + "'");
+				if (last - line < 2 || last[-1] != '|')
+					return Fail(name, data, last - 1, "the row doesn't end with a bar");
+				if (last - line - 2 != SCREEN_WIDTH_TILES)
+					return Fail(name, data, line, "the row has " + std::to_string(last - line - 2) + " tiles instead of " + std::to_string(SCREEN_WIDTH_TILES));
+
+				if (layer == TilesLayer ? !TilesRow(name, data, line + 1, rows[layer]) : !GridRow(name, data, line + 1, rows[layer]))
+					return false;
+				++rows[layer];
+			}
+
+			line = lineEnd + 1;
+		}
+
+		if (!finished())
+			return false;
+		for (int l = 0; l < LevelLayer_Size; ++l)
+			if (headers[l] == nullptr)
+				return Fail(name, data, end, std::string{ "the layer " } + LAYER_NAMES[l] + " is missing");
+		return true;
+	}
+
+	bool CLevelMap::TilesRow(const std::string& name, const char* data, const char* row, int y)
+	{
+		for (int x = 0; x < SCREEN_WIDTH_TILES; ++x)
+		{
+			char ch = row[x];
+			int tile = y * SCREEN_WIDTH_TILES + x;
+			if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z'))
+			{
+				int clip = ch >= 'a' ? 26 + ch - 'a' : ch - 'A';
+				// the pieces of the walls come before the pills on the sprite sheet
+				if (clip >= graphicscore::DOT_PILL)
+					return Fail(name, data, row + x, "the clipping " + std::to_string(clip) + " is not a wall (0-" + std::to_string(graphicscore::DOT_PILL - 1) + ")");
+				_walls.Set(x, y);
+				_clips[tile] = clip;
+			}
+			else if (ch == '.' || ch == '*')
+			{
+				_pills.Set(x, y);
+				if (ch == '*')
+					_energizers.Set(x, y);
+				_clips[tile] = ch == '*' ? graphicscore::ENER_PILL : graphicscore::DOT_PILL;
+			}
+			else if (ch != ' ')
+				return Fail(name, data, row + x, std::string{ "unknown tile '" } + ch + "'");
+		}
+		return true;
+	}
+
+	bool CLevelMap::GridRow(const std::string& name, const char* data, const char* row, int y)
+	{
+		int ends = 0;
+		for (int x = 0; x < SCREEN_WIDTH_TILES; ++x)
+		{
+			char ch = row[x];
+			bool wall = _walls.Test(x, y);
+			switch (ch)
+			{
+			case ' ':
+				if (wall)
+					_obstacles.Set(x, y);
+				break;
+			case '+':
+				if (!wall)
+					return Fail(name, data, row + x, "the tile opened has no wall");
+				break;
+			case 'x':
+				if (wall)
+					return Fail(name, data, row + x, "the tile is already closed by its wall");
+				_obstacles.Set(x, y);
+				break;
+			case 'g':
+			case 's':
+			case 'w':
+				if (wall)
+					return Fail(name, data, row + x, "a zone on a wall");
+				_zones[y * SCREEN_WIDTH_TILES + x] = static_cast<uint8_t>(ch == 'g' ? GroundZone : ch == 's' ? GrassZone : WaterZone);
+				break;
+			case '=':
+				if (x != 0 && x != SCREEN_WIDTH_TILES - 1)
+					return Fail(name, data, row + x, "the tunnel ends go on the first and last tiles of a row");
+				if (wall)
+					return Fail(name, data, row + x, "a tunnel end on a wall");
+				++ends;
+				break;
+			default:
+				return Fail(name, data, row + x, std::string{ "unknown tile '" } + ch + "'");
+			}
+		}
+
+		if (ends == 1)
+			return Fail(name, data, row, "the tunnel has a single end");
+		_tunnels[y] = ends == 2 ? 1 : 0;
+		return true;
+	}
+
+	void CLevelMap::Clear()
+	{
+		_walls.Clear();
+		_obstacles.Clear();
+		_pills.Clear();
+		_energizers.Clear();
+		_clips.fill(-1);
+		_zones.fill(NoZone);
+		_tunnels.fill(0);
+	}
+
+	bool CLevelMap::Fail(const std::string& name, const char* data, const char* position, const std::string& message)
+	{
+		// the lines are only counted when something is wrong
+		int line = 1 + static_cast<int>(std::count(data, position, '\n'));
+		const char* lineStart = position;
+		while (lineStart != data && lineStart[-1] != '\n')
+			--lineStart;
+		int column = 1 + static_cast<int>(position - lineStart);
+
+		Clear();
+		_error = name + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message;
+		return false;
+	}
+}
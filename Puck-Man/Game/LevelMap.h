@@ -0,0 +1,68 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_LEVELMAP_H_
+#define PUCKMAN_GAME_LEVELMAP_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "LevelFile.h"
+#include "TileBitmap.h"
+#include "../Common/Utils.h"
+
+namespace gamecore
+{
+	/*
+	*  Level map class, reads the description of a level: a layer with the tiles of the scenario and
+	*  another with how the ghosts cross them, both drawn as maps with a character per tile; each row
+	*  is turned into the planes of the level as it's read, the same planes that a compiled level
+	*  holds, and the errors point to their line and column
+	*/
+	class CLevelMap
+	{
+	public:
+		CLevelMap() { Clear(); }
+		~CLevelMap() = default;
+
+		// read and check a file, on failure the planes are left empty and the error describes why
+		bool Load(const std::string& filename);
+		// parse the bytes of a file, the name is only used on the errors
+		bool Parse(const char* data, size_t size, const std::string& name);
+
+		// walls of the scenario, tiles closed to the ghosts and pills of each kind
+		const CTileBitmap& Walls() const { return _walls; }
+		const CTileBitmap& Obstacles() const { return _obstacles; }
+		const CTileBitmap& Pills() const { return _pills; }
+		const CTileBitmap& Energizers() const { return _energizers; }
+		// clipping of the sprite of each tile, -1 for the empty ones
+		const std::array<int, CTileBitmap::TILES>& Clips() const { return _clips; }
+		// LevelZone of each tile
+		const std::array<uint8_t, CTileBitmap::TILES>& Zones() const { return _zones; }
+		// 1 for the rows whose first and last tiles lead to each other
+		const std::array<uint8_t, SCREEN_HEIGHT_TILES>& Tunnels() const { return _tunnels; }
+
+		// description of the last error as "file:line:column: message"
+		const std::string& Error() const { return _error; }
+
+	private:
+		// read a row of each layer, the tiles layer is read first so the grid knows the walls
+		bool TilesRow(const std::string& name, const char* data, const char* row, int y);
+		bool GridRow(const std::string& name, const char* data, const char* row, int y);
+
+		// leave the planes empty
+		void Clear();
+		// describe an error found on a position of the data, returns false to be passed along
+		bool Fail(const std::string& name, const char* data, const char* position, const std::string& message);
+
+		CTileBitmap _walls;
+		CTileBitmap _obstacles;
+		CTileBitmap _pills;
+		CTileBitmap _energizers;
+		std::array<int, CTileBitmap::TILES> _clips;
+		std::array<uint8_t, CTileBitmap::TILES> _zones;
+		std::array<uint8_t, SCREEN_HEIGHT_TILES> _tunnels;
+		std::string _error;
+	};
+}
+
+#endif // PUCKMAN_GAME_LEVELMAP_H_
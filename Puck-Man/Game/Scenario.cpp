@@ -1,77 +1,167 @@
-#include <fstream>
 #include "Scenario.h"
-#include "../Graphics/Graphics.h"
+#include "LevelMap.h"
+#include "../Graphics/RenderBackend.h"
 
-#define Clip(type)      _data.Clippings((graphicscore::Clipping)type)
-#define Graphics        graphicscore::CGraphics::Instance()
 #define Grid            CGridWithWeights::Instance()
 
 namespace gamecore
 {
-	bool CScenario::AddSpritesFile(std::string filename, Elements element)
+	bool CScenario::LoadLevel(const std::string& map)
 	{
-		// add walls to the scenario
-		std::ifstream input{ filename, std::ifstream::in };
-
-		// check if the file was opened correctly
-		if (!input.is_open())
+		std::string filename = CLevelFile::CompiledName(map);
+		auto level = std::make_shared<CLevelFile>();
+		if (!level->Open(filename))
 		{
 #if DEBUG_CONSOLE
-			std::cout << "ERROR: Unable to load input sprite file: " << filename << std::endl;
+			std::cout << "Level: " << level->Error() << ", loading its description" << std::endl;
 #endif
 			return false;
 		}
 
-		GLfloat x, y;
-		int c;
-		while (!input.eof())
+		// a description edited after the level was compiled wins, without a description the level
+		// is all there is
+		uint64_t source;
+		if (CLevelFile::Fingerprint(map, source) && source != level->Source())
 		{
-			input >> x;  input.ignore(1, ',');
-			input >> y;  input.ignore(1, ',');
-			input >> c;  input.ignore(1, ',');
-			// add the wall to the sprites map of the scenario
-			_spritesMap[std::make_pair(x, y)] = Clip(c);
-			// add the position to the elements matrix
-			_elementsMatrix[x][y] = element;
+#if DEBUG_CONSOLE
+			std::cout << "Level: " << filename << " is older than " << map << ", loading its description" << std::endl;
+#endif
+			return false;
 		}
-		input.close();
 
+		CTileBitmap walls, energizers;
+		walls.Words(level->Walls());
+		energizers.Words(level->Energizers());
+		_pills.Words(level->Pills());
+		BuildElements(walls, energizers);
+		std::copy(level->Tunnels(), level->Tunnels() + SCREEN_HEIGHT_TILES, _tunnels.begin());
+
+		_sprites.clear();
+		_sprites.reserve(level->SpriteCount());
+		for (size_t i = 0; i < level->SpriteCount(); ++i)
+			AddSprite(level->Sprites()[i].tile, level->Sprites()[i].clip);
+		_firstPill = level->FirstPill();
+
+		// the grid keeps the level to follow its tables of steps
+		Grid.Load(level);
+
+#if DEBUG_CONSOLE
+		std::cout << "Level: " << filename << std::endl;
+#endif
 		return true;
 	}
 
-	bool CScenario::Init()
+	bool CScenario::Init(bool compiled, const std::string& map)
 	{
-		using graphicscore::SIZE_OF_TILE;
+		// start from an empty scenario
+		for (auto& column : _elementsMatrix)
+			column.fill(Empty);
+		_pills.Clear();
 
-		// add wall locations to the scenario map
-		AddSpritesFile("Scenarios/Scenario.txt", Wall);
+		// the compiled level has everything ready, the description is only read without it
+		if (compiled && LoadLevel(map))
+		{
+			BuildZones();
+			return true;
+		}
 
-		// add pill locations to the scenario map
-		AddSpritesFile("Scenarios/Pills.txt", Pill);
+		// the description gives the scenario and the navigation grid of the ghosts
+		CLevelMap level;
+		if (!level.Load(map))
+		{
+#if DEBUG_CONSOLE
+			std::cout << "ERROR: Unable to load the level: " << level.Error() << std::endl;
+#endif
+			return false;
+		}
 
-		// fill the grid with the data about the scenario
-		Grid.Instance().PopulateGrid();
+		_pills = level.Pills();
+		BuildElements(level.Walls(), level.Energizers());
+		_tunnels = level.Tunnels();
+		BuildSprites(level.Clips());
+		Grid.Build(level.Obstacles().Words().data(), level.Zones().data());
+		BuildZones();
 
 		return true;
 	}
 
-	void CScenario::RenderMap()
+	void CScenario::BuildElements(const CTileBitmap& walls, const CTileBitmap& energizers)
+	{
+		walls.ForEach([&](int x, int y) { _elementsMatrix[x][y] = Wall; });
+		_pills.ForEach([&](int x, int y) { _elementsMatrix[x][y] = energizers.Test(x, y) ? Energizer : Pill; });
+	}
+
+	void CScenario::BuildSprites(const std::array<int, CTileBitmap::TILES>& clips)
+	{
+		_sprites.clear();
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			if (pass == 1)
+				_firstPill = _sprites.size();
+
+			for (int tile = 0; tile < CTileBitmap::TILES; ++tile)
+			{
+				int x = tile % SCREEN_WIDTH_TILES, y = tile / SCREEN_WIDTH_TILES;
+				if (clips[tile] < 0 || (_elementsMatrix[x][y] == Wall) != (pass == 0))
+					continue;
+				AddSprite(tile, clips[tile]);
+			}
+		}
+	}
+
+	void CScenario::AddSprite(int tile, int clip)
 	{
-		// add walls and pills
 		using graphicscore::SIZE_OF_TILE;
-		for (auto sprite : _spritesMap)
+
+		int x = tile % SCREEN_WIDTH_TILES, y = tile / SCREEN_WIDTH_TILES;
+		_sprites.push_back(MapSprite{ static_cast<GLfloat>(x * SIZE_OF_TILE - 1), static_cast<GLfloat>(y * SIZE_OF_TILE),
+			static_cast<graphicscore::Clipping>(clip), tile });
+	}
+
+	void CScenario::InitMapLayer()
+	{
+		// the walls never change, they are painted once
+		_data.BeginLayer();
+		for (size_t i = 0; i < _firstPill; ++i)
+			_data.DrawOnLayer(static_cast<int>(_sprites[i].x), static_cast<int>(_sprites[i].y), _sprites[i].clip);
+	}
+
+	void CScenario::RenderMap(graphicscore::CRenderBackend& backend, const CTileBitmap& pills) const
+	{
+		// add the walls with a single quad
+		backend.DrawLayer();
+
+		// add the pills that remain
+		for (size_t i = _firstPill; i < _sprites.size(); ++i)
 		{
-			if (_elementsMatrix[sprite.first.first][sprite.first.second] != Empty)
-				_data.RenderTexture(sprite.first.first * SIZE_OF_TILE - 1, sprite.first.second * SIZE_OF_TILE, &sprite.second);
+			const MapSprite& sprite = _sprites[i];
+			if (pills.Test(sprite.tile))
+				backend.DrawSprite(sprite.x, sprite.y, sprite.clip);
 		}
 
-		// add special zones to the scenario
+		// add special zones to the scenario, their overlay is built when they change
+		backend.DrawQuads(_zones);
+	}
+
+	void CScenario::BuildZones()
+	{
+		_zones.Clear();
 		for (auto zone : Grid.Ground())
-			Graphics.PaintSquare(zone, Color::ORANGE);
+			AddZone(zone, Color::ORANGE);
 		for (auto zone : Grid.Grass())
-			Graphics.PaintSquare(zone, Color::GREEN);
+			AddZone(zone, Color::GREEN);
 		for (auto zone : Grid.Water())
-			Graphics.PaintSquare(zone, Color::BLUE);
+			AddZone(zone, Color::BLUE);
+	}
+
+	void CScenario::AddZone(std::tuple<int, int> location, Color color)
+	{
+		using graphicscore::SIZE_OF_TILE;
+
+		// the columns of the tiles start a pixel to the left
+		GLfloat x = static_cast<GLfloat>(std::get<0>(location) * SIZE_OF_TILE - 1);
+		GLfloat y = static_cast<GLfloat>(std::get<1>(location) * SIZE_OF_TILE);
+		_zones.Add(x, y, SIZE_OF_TILE, SIZE_OF_TILE, graphicscore::ColorRGBA(color, 0.60f));
 	}
 
 	CGridWithWeights& CGridWithWeights::Instance()
@@ -80,67 +170,54 @@ namespace gamecore
 		return grid;
 	}
 
-	void CGridWithWeights::AddRect(CSquareGrid& grid, int x1, int y1, int x2, int y2) {
-		for (int x = x1; x <= x2; ++x) {
-			for (int y = y1; y <= y2; ++y) {
-				grid._walls.insert(CSquareGrid::Location{ x, y });
-			}
-		}
+	void CGridWithWeights::Build(const uint64_t* obstacles, const uint8_t* zones)
+	{
+		_walls.Words(obstacles);
+
+		std::array<std::unordered_set<Location>, LevelZone_Size> sets;
+		for (int tile = 0; tile < CTileBitmap::TILES; ++tile)
+			if (zones[tile] != NoZone)
+				sets[zones[tile]].insert(Location{ tile % SCREEN_WIDTH_TILES, tile / SCREEN_WIDTH_TILES });
+		Ground(sets[GroundZone]);
+		Grass(sets[GrassZone]);
+		Water(sets[WaterZone]);
+
+		_level.reset();
 	}
 
-	void CGridWithWeights::PopulateGrid() {
-		// add walls to the grid
-		AddRect(Grid, 0, 3, 27, 3);
-		AddRect(Grid, 0, 4, 0, 11);
-		AddRect(Grid, 2, 5, 5, 7); AddRect(Grid, 7, 5, 11, 7); AddRect(Grid, 13, 4, 14, 7); AddRect(Grid, 16, 5, 20, 7); AddRect(Grid, 22, 5, 25, 7);
-		AddRect(Grid, 27, 4, 27, 11);
-		AddRect(Grid, 2, 9, 5, 10);
-		AddRect(Grid, 7, 9, 8, 16);
-		AddRect(Grid, 10, 9, 17, 10);
-		AddRect(Grid, 19, 9, 20, 16);
-		AddRect(Grid, 22, 9, 25, 10);
-		AddRect(Grid, 0, 12, 5, 16);
-		AddRect(Grid, 9, 12, 11, 13); AddRect(Grid, 13, 11, 14, 13); AddRect(Grid, 16, 12, 18, 13);
-		AddRect(Grid, 22, 12, 27, 16);
-		AddRect(Grid, 0, 18, 5, 22); AddRect(Grid, 7, 18, 8, 22); AddRect(Grid, 10, 21, 17, 22); AddRect(Grid, 19, 18, 20, 22); AddRect(Grid, 22, 18, 27, 22);
-		AddRect(Grid, 0, 23, 0, 32);
-		AddRect(Grid, 2, 24, 5, 25); AddRect(Grid, 7, 24, 11, 25); AddRect(Grid, 13, 23, 14, 25); AddRect(Grid, 16, 24, 20, 25); AddRect(Grid, 22, 24, 25, 25);
-		AddRect(Grid, 27, 23, 27, 32);
-		AddRect(Grid, 4, 26, 5, 28); AddRect(Grid, 22, 26, 23, 28);
-		AddRect(Grid, 1, 27, 2, 28);
-		AddRect(Grid, 7, 27, 8, 29);
-		AddRect(Grid, 10, 27, 17, 28);
-		AddRect(Grid, 19, 27, 20, 29);
-		AddRect(Grid, 25, 27, 26, 28);
-		AddRect(Grid, 2, 30, 11, 31); AddRect(Grid, 13, 29, 14, 31); AddRect(Grid, 16, 30, 25, 31);
-		AddRect(Grid, 0, 33, 27, 33);
-		// ghosts home square zone
-		AddRect(Grid, 10, 15, 12, 16); AddRect(Grid, 15, 15, 17, 16); AddRect(Grid, 10, 17, 10, 17); AddRect(Grid, 17, 17, 17, 17); AddRect(Grid, 10, 18, 17, 19);
-
-		typedef CSquareGrid::Location L;
-
-		/* special zones on the grid */
-		// add ground zones to the grid
-		Grid.Ground(std::unordered_set<CSquareGrid::Location>
-		{
-			L{ 6, 12 }, L{ 6, 13 }, L{ 6, 14 }, L{ 6, 15 }, L{ 6, 16 }, L{ 6, 17 }, L{ 6, 18 }, L{ 6, 19 }, L{ 6, 20 }, L{ 6, 21 }, L{ 6, 22 },
-				L{ 21, 12 }, L{ 21, 13 }, L{ 21, 14 }, L{ 21, 15 }, L{ 21, 16 }, L{ 21, 17 }, L{ 21, 18 }, L{ 21, 19 }, L{ 21, 20 }, L{ 21, 21 }, L{ 21, 22 }
-		});
-		// add grass zones to the grid
-		Grid.Grass(std::unordered_set<CSquareGrid::Location>
-		{
-			L{ 9, 14 }, L{ 9, 15 }, L{ 10, 14 }, L{ 17, 14 }, L{ 18, 14 }, L{ 18, 15 },
-				L{ 9, 19 }, L{ 9, 20 }, L{ 10, 20 }, L{ 11, 20 }, L{ 12, 20 }, L{ 13, 20 }, L{ 14, 20 }, L{ 15, 20 }, L{ 16, 20 }, L{ 17, 20 }, L{ 18, 20 }, L{ 18, 19 }
-		});
-		// add water zones to the grid
-		Grid.Water(std::unordered_set < CSquareGrid::Location >
+	void CGridWithWeights::Load(std::shared_ptr<const CLevelFile> level)
+	{
+		Build(level->Obstacles(), level->Zones());
+
+		// the weighted steps were compiled with these zones
+		_level = level;
+		_pathsVersion = _zonesVersion;
+	}
+
+	bool CGridWithWeights::FollowPath(PathSearch search, Location start, Location goal, Location& next)
+	{
+		if (!_level || _level->Paths(search) == nullptr || (search == DijkstraPaths && _pathsVersion != _zonesVersion))
+			return false;
+		if (!InBounds(start) || !InBounds(goal))
+			return false;
+
+		int x, y, goalX, goalY;
+		std::tie(x, y) = start;
+		std::tie(goalX, goalY) = goal;
+		uint8_t step = _level->Paths(search)[(y * _w + x) * static_cast<size_t>(CTileBitmap::TILES) + goalY * _w + goalX];
+		if (step == PATH_STAY)
+			next = start;
+		else if (step < PATH_STAY)
 		{
-			L{ 9, 27 }, L{ 9, 28 }, L{ 9, 29 }, L{ 10, 29 }, L{ 11, 29 }, L{ 12, 29 }, L{ 12, 30 }, L{ 12, 31 }, L{ 15, 31 }, L{ 15, 30 }, L{ 15, 29 }, L{ 16, 29 }, L{ 17, 29 }, L{ 18, 29 }, L{ 18, 28 }, L{ 18, 27 }
-		});
+			Location tile{ x + STEP_X[step], y + STEP_Y[step] };
+			if (InBounds(tile))
+				next = tile;
+		}
+		return true;
 	}
 
 	std::unordered_map<CGridWithWeights::Location, CGridWithWeights::Location>
-		CGridWithWeights::BreadthFirstSearch(CGridWithWeights graph, CGridWithWeights::Location start, CGridWithWeights::Location goal)
+		CGridWithWeights::BreadthFirstSearch(CGridWithWeights& graph, CGridWithWeights::Location start, CGridWithWeights::Location goal)
 	{
 		typedef CSquareGrid::Location Location;
 		std::queue<Location> frontier;
@@ -167,7 +244,7 @@ namespace gamecore
 		return came_from;
 	}
 
-	void CGridWithWeights::DijkstraSearch(CGridWithWeights graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
+	void CGridWithWeights::DijkstraSearch(CGridWithWeights& graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
 		std::unordered_map<CGridWithWeights::Location, CGridWithWeights::Location>& came_from, std::unordered_map<CGridWithWeights::Location, int>& cost_so_far)
 	{
 		typedef CGridWithWeights::Location Location;
@@ -195,7 +272,7 @@ namespace gamecore
 		}
 	}
 
-	void CGridWithWeights::AStarSearch(CGridWithWeights graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
+	void CGridWithWeights::AStarSearch(CGridWithWeights& graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
 		std::unordered_map<CGridWithWeights::Location, CGridWithWeights::Location>& came_from, std::unordered_map<CGridWithWeights::Location, int>& cost_so_far)
 	{
 		typedef CGridWithWeights::Location Location;
@@ -5,13 +5,17 @@
 
 #include <array>
 #include <functional>
-#include <map>
+#include <memory>
 #include <queue>
+#include <string>
 #include <tuple>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "LevelFile.h"
+#include "TileBitmap.h"
+#include "../Graphics/QuadLayer.h"
 #include "../Graphics/Textures.h"
 #include "../Common/Utils.h"
 
@@ -27,6 +31,11 @@ namespace std {
 	};
 }
 
+namespace graphicscore
+{
+	class CRenderBackend;
+}
+
 namespace gamecore
 {
 	using graphicscore::CData;
@@ -36,9 +45,14 @@ namespace gamecore
 	template<typename Type, size_t Row, size_t Col>
 	using Matrix = std::array<std::array<Type, Col>, Row>;
 
-	// definition of the sprite type
-	template<typename Type1, typename Type2>
-	using Sprite = std::pair<std::pair<Type1, Type1>, Type2>;
+	// sprite of a tile of the map, prebuilt with its position on screen
+	struct MapSprite
+	{
+		GLfloat x, y;
+		graphicscore::Clipping clip;
+		// index of the tile on the tile bitmaps
+		int tile;
+	};
 
 	// elements on the screen
 	const enum Elements
@@ -49,6 +63,9 @@ namespace gamecore
 		Wall
 	};
 
+	// matrix with the element found on each tile of the screen
+	typedef Matrix<Elements, SCREEN_WIDTH_TILES, SCREEN_HEIGHT_TILES> TilesMatrix;
+
 	// definition of a Square Grid
 	class CSquareGrid {
 	public:
@@ -64,7 +81,9 @@ namespace gamecore
 		}
 
 		inline bool Passable(Location id) {
-			return !_walls.count(id);
+			int x, y;
+			std::tie(x, y) = id;
+			return !_walls.Test(x, y);
 		}
 
 		std::vector<Location> Neighbors(Location id) {
@@ -87,7 +106,7 @@ namespace gamecore
 			return results;
 		}
 
-		std::unordered_set<Location> _walls;
+		CTileBitmap _walls;
 
 	protected:
 		int _w, _h;
@@ -97,7 +116,7 @@ namespace gamecore
 	class CGridWithWeights : public CSquareGrid
 	{
 	public:
-		CGridWithWeights(int w, int h) : CSquareGrid(w, h) {}
+		CGridWithWeights(int w, int h) : CSquareGrid(w, h), _zonesVersion{ 0 }, _pathsVersion{ 0 } {}
 		~CGridWithWeights() = default;
 
 		int Cost(Location l) {
@@ -112,33 +131,53 @@ namespace gamecore
 
 		static CGridWithWeights& Instance();
 
-		void AddRect(CSquareGrid& grid, int x1, int y1, int x2, int y2);
+		// fill the grid with the tiles closed to the ghosts and the LevelZone of each tile, the tables
+		// of steps of a previous level are dropped
+		void Build(const uint64_t* obstacles, const uint8_t* zones);
 
-		void PopulateGrid();
+		// fill the grid with a compiled level, the grid keeps the file mapped to follow its tables of steps
+		void Load(std::shared_ptr<const CLevelFile> level);
+
+		// take the next tile towards a goal from the table of a search, as the search followed by
+		// ReconstructPath would give it; returns false when there's no table (or the zones changed
+		// since it was compiled) and the search has to be run
+		bool FollowPath(PathSearch search, Location start, Location goal, Location& next);
 
 		std::unordered_map<CGridWithWeights::Location, CGridWithWeights::Location>
-			BreadthFirstSearch(CGridWithWeights graph, CGridWithWeights::Location start, CGridWithWeights::Location goal);
+			BreadthFirstSearch(CGridWithWeights& graph, CGridWithWeights::Location start, CGridWithWeights::Location goal);
 
-		void CGridWithWeights::DijkstraSearch(CGridWithWeights graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
+		void CGridWithWeights::DijkstraSearch(CGridWithWeights& graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
 			std::unordered_map<CGridWithWeights::Location, CGridWithWeights::Location>& came_from, std::unordered_map<CGridWithWeights::Location, int>& cost_so_far);
 
-		void AStarSearch(CGridWithWeights graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
+		void AStarSearch(CGridWithWeights& graph, CGridWithWeights::Location start, CGridWithWeights::Location goal,
 			std::unordered_map<CGridWithWeights::Location, CGridWithWeights::Location>& came_from, std::unordered_map<CGridWithWeights::Location, int>& cost_so_far);
 
 		std::vector<CGridWithWeights::Location> CGridWithWeights::ReconstructPath(CGridWithWeights::Location start, CGridWithWeights::Location goal,
 			std::unordered_map<CGridWithWeights::Location, CGridWithWeights::Location>& came_from);
 
 		std::unordered_set<Location>& Ground() { return _ground; }
-		void Ground(std::unordered_set<Location> ground) { _ground = ground; }
+		void Ground(std::unordered_set<Location> ground) { _ground = ground; ZonesChanged(); }
 		std::unordered_set<Location>& Grass() { return _grass; }
-		void Grass(std::unordered_set<Location> grass) { _grass = grass; }
+		void Grass(std::unordered_set<Location> grass) { _grass = grass; ZonesChanged(); }
 		std::unordered_set<Location>& Water() { return _water; }
-		void Water(std::unordered_set<Location> water) { _water = water; }
+		void Water(std::unordered_set<Location> water) { _water = water; ZonesChanged(); }
+
+		// version of the special zones, it changes every time they are set; the zones changed through
+		// their references must be announced with ZonesChanged so the weighted steps of a compiled
+		// level are left aside
+		unsigned int ZonesVersion() { return _zonesVersion; }
+		void ZonesChanged() { ++_zonesVersion; }
 
 	private:
 		std::unordered_set<Location> _ground;
 		std::unordered_set<Location> _grass;
 		std::unordered_set<Location> _water;
+		// version 0 stands for no zones at all
+		unsigned int _zonesVersion;
+
+		// compiled level with the tables of steps and the version of the zones the weighted ones follow
+		std::shared_ptr<const CLevelFile> _level;
+		unsigned int _pathsVersion;
 
 		inline int Heuristic(CSquareGrid::Location a, CSquareGrid::Location b) {
 			int x1, y1, x2, y2;
@@ -169,35 +208,70 @@ namespace gamecore
 	class CScenario
 	{
 	public:
-		CScenario() = default;
+		CScenario() : _firstPill{ 0 } { _tunnels.fill(0); }
 		~CScenario() = default;
 
-		// load the scenario information
-		bool Init();
+		// load the scenario information from the description of a level, or from its compiled level
+		// when there's one and it's allowed
+		bool Init(bool compiled = true, const std::string& map = LEVEL_MAP);
+
+		// compose the walls on a static layer, it needs the sprites loaded
+		void InitMapLayer();
+
+		// sprites of the map in tile order, the pills start at FirstPill
+		const std::vector<MapSprite>& Sprites() { return _sprites; }
+		size_t FirstPill() { return _firstPill; }
 
-		// render the scenario map on screen
-		void RenderMap();
+		// render the scenario map through a backend with the pills that remain on the given bitmap, it
+		// only reads the scenario so the capture can paint it on its own thread
+		void RenderMap(graphicscore::CRenderBackend& backend, const CTileBitmap& pills) const;
+
+		// build the overlay of the special zones of the grid again, it has to be called after they
+		// change and before the next frame is painted
+		void BuildZones();
 
 		CData& Data() { return _data; }
 
-		Matrix<Elements, SCREEN_WIDTH_TILES, SCREEN_HEIGHT_TILES>& ElementsMatrix() { return _elementsMatrix; }
+		// initial layout of the elements, every world starts with a copy of it
+		TilesMatrix& ElementsMatrix() { return _elementsMatrix; }
 		void ElementsMatrix(int x, int y, Elements e) { _elementsMatrix[x][y] = e; }
 
+		// tiles that hold a pill or an energizer when the level starts
+		CTileBitmap& Pills() { return _pills; }
+
+		// check if the first and last tiles of a row lead to each other
+		bool Tunnel(int row) { return _tunnels[row] != 0; }
+
 	private:
 		// object that holds the scenario sprite data
 		CData _data;
 
 		// matrix to hold the type of elements on the screen (for collisions' detection)
-		Matrix<Elements, SCREEN_WIDTH_TILES, SCREEN_HEIGHT_TILES> _elementsMatrix;
-
-		// map to hold the sprites shown on the scenario
-		std::map<std::pair<GLfloat, GLfloat>, LFRect> _spritesMap;
-
-		// vector to hold the arrange of the sprites of the scenario
-		std::vector<Sprite<GLfloat, LFRect>> _spritesVector;
-
-		// method to add the content of a file to the sprites map
-		bool CScenario::AddSpritesFile(std::string filename, Elements element);
+		TilesMatrix _elementsMatrix;
+
+		// initial pills of the level
+		CTileBitmap _pills;
+
+		// rows of the level with a tunnel
+		std::array<uint8_t, SCREEN_HEIGHT_TILES> _tunnels;
+
+		// sprites of the map in tile order, the walls first and then the pills
+		std::vector<MapSprite> _sprites;
+		size_t _firstPill;
+
+		// overlay with the special zones of the grid
+		graphicscore::CQuadLayer _zones;
+
+		// method to load the scenario and the grid from the compiled level of a description
+		bool LoadLevel(const std::string& map);
+		// method to fill the elements matrix with the walls and the initial pills
+		void BuildElements(const CTileBitmap& walls, const CTileBitmap& energizers);
+		// method to build the sprites of the tiles with an element
+		void BuildSprites(const std::array<int, CTileBitmap::TILES>& clips);
+		// method to add the sprite of a tile with its position on screen
+		void AddSprite(int tile, int clip);
+		// method to add a special zone to the overlay
+		void AddZone(std::tuple<int, int> location, Color color);
 	};
 }
 
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cstdlib>
+#include "TileBitmap.h"
+
+namespace gamecore
+{
+	void CTileBitmap::Fill()
+	{
+		_words.fill(~uint64_t{ 0 });
+		// leave the bits past the last tile clear so the count is right
+		if (TILES % 64 != 0)
+			_words[WORDS - 1] = (uint64_t{ 1 } << (TILES % 64)) - 1;
+		_count = TILES;
+	}
+
+	void CTileBitmap::SetRect(int left, int top, int right, int bottom)
+	{
+		left = std::max(left, 0);
+		top = std::max(top, 0);
+		right = std::min(right, SCREEN_WIDTH_TILES - 1);
+		bottom = std::min(bottom, SCREEN_HEIGHT_TILES - 1);
+		for (int y = top; y <= bottom; ++y)
+			for (int x = left; x <= right; ++x)
+				Set(x, y);
+	}
+
+	void CTileBitmap::Words(const uint64_t* words)
+	{
+		_count = 0;
+		for (int w = 0; w < WORDS; ++w)
+		{
+			_words[w] = words[w];
+			_count += PopCount(_words[w]);
+		}
+	}
+
+	CTileBitmap& CTileBitmap::operator|=(const CTileBitmap& other)
+	{
+		_count = 0;
+		for (int w = 0; w < WORDS; ++w)
+		{
+			_words[w] |= other._words[w];
+			_count += PopCount(_words[w]);
+		}
+		return *this;
+	}
+
+	bool CTileBitmap::Nearest(int x, int y, int& nearestX, int& nearestY) const
+	{
+		int best = -1;
+		ForEach([&](int tx, int ty)
+		{
+			int distance = std::abs(tx - x) + std::abs(ty - y);
+			if (best < 0 || distance < best)
+			{
+				best = distance;
+				nearestX = tx;
+				nearestY = ty;
+			}
+		});
+		return best >= 0;
+	}
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_TILEBITMAP_H_
+#define PUCKMAN_GAME_TILEBITMAP_H_
+
+#include <array>
+#include <cstdint>
+#include "../Common/Utils.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace gamecore
+{
+	// number of bits set on a word
+	inline int PopCount(uint64_t word)
+	{
+#if defined(_MSC_VER)
+		// the 64 bits intrinsic is not available on 32 bits builds
+		return static_cast<int>(__popcnt(static_cast<unsigned int>(word)) + __popcnt(static_cast<unsigned int>(word >> 32)));
+#else
+		return __builtin_popcountll(word);
+#endif
+	}
+
+	// position of the lowest bit set on a word that is not zero
+	inline int LowestBit(uint64_t word)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+			return static_cast<int>(index);
+		_BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+		return static_cast<int>(index) + 32;
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	/*
+	*  Tile bitmap class, one bit per tile of the screen packed in 64 bits words with the number of bits set
+	*/
+	class CTileBitmap
+	{
+	public:
+		static const int TILES = SCREEN_WIDTH_TILES * SCREEN_HEIGHT_TILES;
+		static const int WORDS = (TILES + 63) / 64;
+
+		CTileBitmap() : _count{ 0 } { _words.fill(0); }
+		~CTileBitmap() = default;
+
+		// check if the bit of a tile is set, by its coordinates or by its index (y * SCREEN_WIDTH_TILES + x)
+		bool Test(int x, int y) const { return Test(Index(x, y)); }
+		bool Test(int i) const { return ((_words[i >> 6] >> (i & 63)) & 1) != 0; }
+
+		// set the bit of a tile
+		void Set(int x, int y)
+		{
+			int i = Index(x, y);
+			uint64_t bit = uint64_t{ 1 } << (i & 63);
+			_count += (_words[i >> 6] & bit) == 0 ? 1 : 0;
+			_words[i >> 6] |= bit;
+		}
+
+		// clear the bit of a tile
+		void Reset(int x, int y)
+		{
+			int i = Index(x, y);
+			uint64_t bit = uint64_t{ 1 } << (i & 63);
+			_count -= (_words[i >> 6] & bit) != 0 ? 1 : 0;
+			_words[i >> 6] &= ~bit;
+		}
+
+		// clear every bit
+		void Clear() { _words.fill(0); _count = 0; }
+		// set every bit
+		void Fill();
+
+		// set the bits of a rectangle of tiles, the parts outside of the screen are left out
+		void SetRect(int left, int top, int right, int bottom);
+
+		// set the bits that are set on another bitmap
+		CTileBitmap& operator|=(const CTileBitmap& other);
+
+		// number of bits set, it's kept up to date so it costs nothing
+		int Count() const { return _count; }
+		bool Empty() const { return _count == 0; }
+
+		// find the set tile closest to the given one (Manhattan distance), returns false if there's none
+		bool Nearest(int x, int y, int& nearestX, int& nearestY) const;
+
+		// call the function with the coordinates of every set tile, in row order
+		template<typename Function>
+		void ForEach(Function function) const
+		{
+			for (int w = 0; w < WORDS; ++w)
+			{
+				for (uint64_t word = _words[w]; word != 0; word &= word - 1)
+				{
+					int i = (w << 6) + LowestBit(word);
+					function(i % SCREEN_WIDTH_TILES, i / SCREEN_WIDTH_TILES);
+				}
+			}
+		}
+
+		// call the function with rectangles (x, y, width, height) that cover the set tiles, the runs of
+		// each row are joined with the same runs of the rows below
+		template<typename Function>
+		void ForEachRect(Function function) const
+		{
+			CTileBitmap pending = *this;
+			for (int y = 0; y < SCREEN_HEIGHT_TILES; ++y)
+			{
+				for (int x = 0; x < SCREEN_WIDTH_TILES; ++x)
+				{
+					if (!pending.Test(x, y))
+						continue;
+
+					int width = 1;
+					while (x + width < SCREEN_WIDTH_TILES && pending.Test(x + width, y))
+						++width;
+
+					int height = 1;
+					while (y + height < SCREEN_HEIGHT_TILES && pending.Run(x, y + height, width))
+						++height;
+
+					for (int row = y; row < y + height; ++row)
+						for (int column = x; column < x + width; ++column)
+							pending.Reset(column, row);
+
+					function(x, y, width, height);
+					x += width - 1;
+				}
+			}
+		}
+
+		// access the packed words
+		const std::array<uint64_t, WORDS>& Words() const { return _words; }
+		// replace the packed words, the bits past the last tile must be clear
+		void Words(const uint64_t* words);
+
+	private:
+		std::array<uint64_t, WORDS> _words;
+		int _count;
+
+		static int Index(int x, int y) { return y * SCREEN_WIDTH_TILES + x; }
+
+		// check that the bits of a row segment are all set
+		bool Run(int x, int y, int width) const
+		{
+			for (int i = 0; i < width; ++i)
+				if (!Test(x + i, y))
+					return false;
+			return true;
+		}
+	};
+}
+
+#endif // PUCKMAN_GAME_TILEBITMAP_H_
@@ -0,0 +1,133 @@
+#include <cstring>
+#include "VectorEnv.h"
+
+namespace gamecore
+{
+	CVectorEnv::CVectorEnv(size_t worlds, size_t threads, unsigned int maxSteps) :
+		_worlds(worlds), _maxSteps{ maxSteps }, _actions{ nullptr }, _observations{ nullptr }, _rewards{ nullptr }, _dones{ nullptr }, _pool{ threads }
+	{
+		_resetJob = [this](size_t begin, size_t end) { ResetRange(begin, end); };
+		_stepJob = [this](size_t begin, size_t end) { StepRange(begin, end); };
+	}
+
+	bool CVectorEnv::Init(unsigned int seed, bool compiled)
+	{
+		// load the walls and pills, the textures are not needed to simulate
+		if (!_scenario.Init(compiled))
+			return false;
+
+		// the walls never change, build their plane once
+		for (int y = 0; y < SCREEN_HEIGHT_TILES; ++y)
+			for (int x = 0; x < SCREEN_WIDTH_TILES; ++x)
+				_walls[y * SCREEN_WIDTH_TILES + x] = _scenario.ElementsMatrix()[x][y] == Wall ? 1 : 0;
+
+		// give each world its own random sequence
+		for (size_t i = 0; i < _worlds.size(); ++i)
+		{
+			_worlds[i].Seed(seed + static_cast<unsigned int>(i) + 1);
+			_worlds[i].Init(_scenario);
+		}
+
+		return true;
+	}
+
+	bool CVectorEnv::InitRendering()
+	{
+		// DevIL decodes the sprites, nothing is uploaded to OpenGL
+		ilInit();
+		iluInit();
+		if (!_scenario.Data().LoadSprites(false))
+			return false;
+
+		_scenario.InitMapLayer();
+		return true;
+	}
+
+	void CVectorEnv::Render(size_t index, graphicscore::CRenderBackend& backend)
+	{
+		GameFrame frame;
+		frame.Capture(_worlds[index]);
+		// the worlds are stepped as a whole, the characters are painted on their current tile
+		backend.Begin();
+		backend.Clear();
+		backend.PaintFrame(_scenario, frame, 1.f);
+	}
+
+	void CVectorEnv::Reset(uint8_t* observations)
+	{
+		_observations = observations;
+		_pool.Run(_worlds.size(), _resetJob);
+	}
+
+	void CVectorEnv::Step(const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones)
+	{
+		_actions = actions;
+		_observations = observations;
+		_rewards = rewards;
+		_dones = dones;
+		_pool.Run(_worlds.size(), _stepJob);
+	}
+
+	void CVectorEnv::ResetRange(size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			_worlds[i].Reset();
+			Observe(i);
+		}
+	}
+
+	void CVectorEnv::StepRange(size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto& world = _worlds[i];
+
+			// actions out of the range of directions keep the current one
+			if (_actions[i] <= Down)
+				world.Pacman().ChangeDirection(static_cast<Direction>(_actions[i]));
+
+			auto result = world.Step();
+			bool done = result.caught || result.cleared || (_maxSteps != 0 && world.Ticks() >= _maxSteps);
+
+			_rewards[i] = static_cast<float>(result.reward);
+			_dones[i] = done ? 1 : 0;
+
+			// start a new episode as soon as the current one finishes
+			if (done)
+				world.Reset();
+
+			Observe(i);
+		}
+	}
+
+	void CVectorEnv::Observe(size_t index)
+	{
+		auto& world = _worlds[index];
+		uint8_t* observation = _observations + index * OBSERVATION_SIZE;
+
+		std::memcpy(observation + WallsPlane * PLANE_SIZE, _walls.data(), PLANE_SIZE);
+
+		// the pills and characters planes are cleared together, they are next to each other
+		std::memset(observation + PillsPlane * PLANE_SIZE, 0, 3 * PLANE_SIZE);
+
+		uint8_t* pills = observation + PillsPlane * PLANE_SIZE;
+		auto& layout = world.Layout();
+		world.Pills().ForEach([&](int x, int y)
+		{
+			pills[y * SCREEN_WIDTH_TILES + x] = layout[x][y] == Energizer ? 2 : 1;
+		});
+
+		uint8_t* ghosts = observation + GhostsPlane * PLANE_SIZE;
+		for (auto& ghost : world.Ghosts())
+		{
+			int x, y;
+			std::tie(x, y) = ghost.Position();
+			++ghosts[y * SCREEN_WIDTH_TILES + x];
+		}
+
+		int x, y;
+		std::tie(x, y) = world.Pacman().Position();
+		observation[PacmanPlane * PLANE_SIZE + y * SCREEN_WIDTH_TILES + x] = 1;
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_VECTORENV_H_
+#define PUCKMAN_GAME_VECTORENV_H_
+
+#include <cstdint>
+#include <vector>
+#include "Frame.h"
+#include "World.h"
+#include "Scenario.h"
+#include "../Graphics/RenderBackend.h"
+#include "../Common/WorkerPool.h"
+#include "../Common/Utils.h"
+
+namespace gamecore
+{
+	/*
+	*  Vectorized environment class, steps many worlds in lockstep for reinforcement learning
+	*
+	*  the observation of each world is made of OBSERVATION_PLANES planes of 28x36 bytes stored
+	*  row by row (plane, y, x) and the observations of all the worlds are contiguous:
+	*    - walls:  1 on each wall tile
+	*    - pills:  1 on each pill tile, 2 on each energizer tile
+	*    - ghosts: number of ghosts on each tile
+	*    - Pacman: 1 on the tile of Pacman
+	*/
+	class CVectorEnv
+	{
+	public:
+		// planes of an observation
+		const enum Plane
+		{
+			WallsPlane = 0,
+			PillsPlane,
+			GhostsPlane,
+			PacmanPlane,
+			// element to obtain size of the enumeration
+			Plane_Size
+		};
+
+		static const size_t PLANE_SIZE = SCREEN_WIDTH_TILES * SCREEN_HEIGHT_TILES;
+		static const size_t OBSERVATION_SIZE = PLANE_SIZE * Plane_Size;
+
+		// create the environment, zero threads means one per hardware core and zero
+		// steps means that the episodes only end when Pacman is caught or clears the level
+		CVectorEnv(size_t worlds, size_t threads = 0, unsigned int maxSteps = 0);
+		~CVectorEnv() = default;
+
+		// load the scenario shared by all the worlds, from the compiled level when there's one and
+		// it's allowed
+		bool Init(unsigned int seed = 0, bool compiled = true);
+
+		// number of worlds stepped on each call
+		size_t Size() { return _worlds.size(); }
+
+		// reset every world and write its observation, the buffer holds Size() * OBSERVATION_SIZE bytes
+		void Reset(uint8_t* observations);
+
+		// apply one action (a Direction) per world, advance all the worlds one tick and write their
+		// observations, rewards and done flags, finished worlds are reset and the observation
+		// written for them is the first one of the new episode
+		void Step(const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones);
+
+		// access a single world (e.g. to render it)
+		CWorld& World(size_t index) { return _worlds[index]; }
+		// scenario shared by all the worlds
+		CScenario& Scenario() { return _scenario; }
+
+		// load the sprites and compose the walls on memory so the worlds can be rendered without a window,
+		// it must be called after Init
+		bool InitRendering();
+
+		// paint the current state of a world, the backend must be initialized with Scenario()
+		void Render(size_t index, graphicscore::CRenderBackend& backend);
+
+	private:
+		// scenario shared by all the worlds
+		CScenario _scenario;
+		std::vector<CWorld> _worlds;
+		unsigned int _maxSteps;
+
+		// walls plane, the same for all the worlds
+		std::array<uint8_t, PLANE_SIZE> _walls;
+
+		// arguments of the batch being processed by the workers
+		const uint8_t* _actions;
+		uint8_t* _observations;
+		float* _rewards;
+		uint8_t* _dones;
+
+		commoncore::CWorkerPool _pool;
+		// jobs given to the pool, created once to avoid an allocation on every step
+		commoncore::CWorkerPool::Job _resetJob;
+		commoncore::CWorkerPool::Job _stepJob;
+
+		// reset and step a range of worlds
+		void ResetRange(size_t begin, size_t end);
+		void StepRange(size_t begin, size_t end);
+
+		// write the observation of a world
+		void Observe(size_t index);
+
+		/* remove these features to avoid copies of the worlds */
+		// remove the copy constructor
+		CVectorEnv(const CVectorEnv& src) = delete;
+		// remove the copy assign operator
+		const CVectorEnv& operator=(const CVectorEnv& rhs) = delete;
+	};
+}
+
+#endif // PUCKMAN_GAME_VECTORENV_H_
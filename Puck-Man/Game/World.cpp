@@ -0,0 +1,100 @@
+#include "World.h"
+#include "Collisions.h"
+
+namespace gamecore
+{
+	void CWorld::Init(CScenario& scenario)
+	{
+		_scenario = &scenario;
+
+		// create a ghost of each color
+		_ghosts = { { Ghost{ Red }, Ghost{ Pink }, Ghost{ Blue }, Ghost{ Orange } } };
+
+		Reset();
+	}
+
+	void CWorld::Reset()
+	{
+		// put back the pills of the level, everything on screen changes
+		_pills = _scenario->Pills();
+		_dirty.Fill();
+
+		_score = 0;
+		_ticks = 0;
+
+		// initialize Pacman
+		_pacman.Init();
+		_pacman.Settle();
+
+		// initialize the ghosts
+		for (auto& ghost : _ghosts)
+		{
+			ghost.Init();
+			ghost.Settle();
+		}
+	}
+
+	void CWorld::ResetGhosts()
+	{
+		// clear them from where they are before moving them
+		for (auto& ghost : _ghosts)
+		{
+			ghost.MarkDirty(_dirty);
+			ghost.Reset();
+			ghost.MarkDirty(_dirty);
+		}
+	}
+
+	StepResult CWorld::Step()
+	{
+		int score = _score;
+		++_ticks;
+
+		// remember where the characters were to show them moving between both positions
+		_pacman.Settle();
+		for (auto& ghost : _ghosts)
+			ghost.Settle();
+
+		// move Pacman on the scenario
+		_pacman.Move(*this);
+
+		// move the Ghosts on the scenario
+		for (auto& ghost : _ghosts)
+			ghost.Move(*this);
+
+		// the characters are shown anywhere between both positions until the next tick
+		_pacman.MarkDirty(_dirty);
+		for (auto& ghost : _ghosts)
+			ghost.MarkDirty(_dirty);
+
+		// collision stage, the grid is only scratch space so each thread keeps its own one
+		// instead of making every world (and every copy of it) carry a grid
+		static thread_local CCollisionGrid collisions;
+		collisions.Begin();
+		for (unsigned int i = 0; i < _ghosts.size(); ++i)
+			collisions.AddGhost(i, _ghosts[i].PreviousCell(), _ghosts[i].Cell());
+		bool caught = collisions.Test(_pacman.PreviousCell(), _pacman.Cell()) != 0;
+		if (caught)
+		{
+			int x, y;
+			std::tie(x, y) = _pacman.Cell();
+			_events.Push(GameEvent{ PacmanCaught, x, y, 0, _ticks });
+		}
+
+		return StepResult{ _score - score, caught, _pills.Empty() };
+	}
+
+	void CWorld::Eat(int x, int y)
+	{
+		bool energizer = Layout()[x][y] == Energizer;
+		int points = energizer ? ENERGIZER_POINTS : PILL_POINTS;
+
+		_pills.Reset(x, y);
+		_dirty.Set(x, y);
+		_score += points;
+
+		_events.Push(GameEvent{ energizer ? EnergizerEaten : PillEaten, x, y, points, _ticks });
+		if (_pills.Empty())
+			_events.Push(GameEvent{ LevelCleared, x, y, 0, _ticks });
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#ifndef PUCKMAN_GAME_WORLD_H_
+#define PUCKMAN_GAME_WORLD_H_
+
+#include <array>
+#include <random>
+#include "Characters.h"
+#include "Events.h"
+#include "Scenario.h"
+#include "TileBitmap.h"
+#include "../Common/Utils.h"
+
+namespace gamecore
+{
+	// outcome of a single simulation tick
+	struct StepResult
+	{
+		// points earned during the tick
+		int reward;
+		// a ghost reached Pacman
+		bool caught;
+		// all the pills of the level were eaten
+		bool cleared;
+	};
+
+	/*
+	*  World class, holds the state that changes while playing (elements, characters and score)
+	*  so several games can be simulated at the same time over a single scenario
+	*/
+	class CWorld
+	{
+	public:
+		CWorld() : _scenario{ nullptr }, _score{ 0 }, _ticks{ 0 } {}
+		~CWorld() = default;
+
+		// attach the world to a loaded scenario and place everything on its initial state
+		void Init(CScenario& scenario);
+
+		// restore the initial state of the world
+		void Reset();
+		// send the ghosts back to their initial positions
+		void ResetGhosts();
+
+		// advance the simulation one tick
+		StepResult Step();
+
+		// seed the random generator used by the characters
+		void Seed(unsigned int seed) { _random.seed(seed); }
+
+		// static layout of the elements of the world, walls and the kind of pill of each tile
+		TilesMatrix& Layout() { return _scenario->ElementsMatrix(); }
+		// check if the first and last tiles of a row lead to each other
+		bool Tunnel(int row) { return _scenario->Tunnel(row); }
+		// tiles that still have a pill or an energizer
+		CTileBitmap& Pills() { return _pills; }
+		// Pacman character of the world
+		CPacman& Pacman() { return _pacman; }
+		// Ghosts of the world
+		std::array<CGhost, Ghost_Size>& Ghosts() { return _ghosts; }
+		// random generator of the world
+		std::minstd_rand& Random() { return _random; }
+		// events raised by the world
+		CEventQueue& Events() { return _events; }
+		// tiles whose look changed since the bitmap was last cleared
+		CTileBitmap& Dirty() { return _dirty; }
+
+		// get the score of the current game
+		int Score() { return _score; }
+		// get the number of ticks since the last reset
+		unsigned int Ticks() { return _ticks; }
+
+		// take the pill or energizer of a tile adding its points to the score
+		void Eat(int x, int y);
+
+	private:
+		// scenario used as a template for the elements
+		CScenario* _scenario;
+
+		// pills that remain on the world
+		CTileBitmap _pills;
+		// tiles to paint again, they accumulate until somebody clears them
+		CTileBitmap _dirty;
+		// Pacman object
+		CPacman _pacman;
+		// Ghosts array
+		std::array<CGhost, Ghost_Size> _ghosts;
+
+		// random generator for the characters movement
+		std::minstd_rand _random;
+
+		// queue to notify the events to the rest of the game
+		CEventQueue _events;
+
+		int _score;
+		unsigned int _ticks;
+	};
+}
+
+#endif // PUCKMAN_GAME_WORLD_H_
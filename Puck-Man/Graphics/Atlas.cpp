@@ -0,0 +1,91 @@
+#include <algorithm>
+#include "Atlas.h"
+#include "Textures.h"
+
+namespace graphicscore
+{
+	void CAtlasPacker::Pack(const std::vector<LFRect>& clippings, bool powerOfTwo)
+	{
+		// the tallest clippings go first so the shelves waste less space
+		std::vector<size_t> order;
+		int widest = 0;
+		for (size_t i = 0; i < clippings.size(); ++i)
+		{
+			if (clippings[i].w <= 0.f || clippings[i].h <= 0.f)
+				continue;
+			order.push_back(i);
+			widest = std::max(widest, static_cast<int>(clippings[i].w) + 2 * _padding);
+		}
+		std::stable_sort(order.begin(), order.end(), [&clippings](size_t a, size_t b) { return clippings[a].h > clippings[b].h; });
+
+		// try the widths that can hold the widest clipping and keep the one with less area
+		long long best = -1;
+		std::vector<LFRect> placed;
+		for (int width = widest; width <= 2048; width += powerOfTwo ? width : 2)
+		{
+			if (powerOfTwo)
+				width = static_cast<int>(CTexture::PowerOfTwo(width));
+
+			int height = Shelve(clippings, order, width, placed);
+			long long area = static_cast<long long>(width) * (powerOfTwo ? CTexture::PowerOfTwo(height) : height);
+			if (best < 0 || area < best)
+			{
+				best = area;
+				_width = width;
+				_height = height;
+				_placed = placed;
+			}
+		}
+	}
+
+	int CAtlasPacker::Shelve(const std::vector<LFRect>& clippings, const std::vector<size_t>& order, int width, std::vector<LFRect>& placed)
+	{
+		placed = clippings;
+
+		int x = 0, y = 0, shelf = 0;
+		for (auto i : order)
+		{
+			int w = static_cast<int>(clippings[i].w) + 2 * _padding;
+			int h = static_cast<int>(clippings[i].h) + 2 * _padding;
+
+			// open a new shelf under the current one when the clipping doesn't fit
+			if (x + w > width)
+			{
+				x = 0;
+				y += shelf;
+				shelf = 0;
+			}
+
+			placed[i].x = static_cast<GLfloat>(x + _padding);
+			placed[i].y = static_cast<GLfloat>(y + _padding);
+			x += w;
+			shelf = std::max(shelf, h);
+		}
+		return y + shelf;
+	}
+
+	void CAtlasPacker::Compose(const std::vector<LFRect>& clippings, const GLuint* source, int sourceWidth, GLuint* atlas, int atlasWidth)
+	{
+		for (size_t i = 0; i < clippings.size(); ++i)
+		{
+			const LFRect& from = clippings[i];
+			const LFRect& to = _placed[i];
+			if (from.w <= 0.f || from.h <= 0.f)
+				continue;
+
+			int w = static_cast<int>(from.w), h = static_cast<int>(from.h);
+			for (int row = -_padding; row < h + _padding; ++row)
+			{
+				// the border repeats the nearest pixel of the clipping
+				int sy = static_cast<int>(from.y) + std::min(std::max(row, 0), h - 1);
+				int dy = static_cast<int>(to.y) + row;
+				for (int column = -_padding; column < w + _padding; ++column)
+				{
+					int sx = static_cast<int>(from.x) + std::min(std::max(column, 0), w - 1);
+					int dx = static_cast<int>(to.x) + column;
+					atlas[dy * atlasWidth + dx] = source[sy * sourceWidth + sx];
+				}
+			}
+		}
+	}
+}
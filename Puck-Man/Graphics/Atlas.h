@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_ATLAS_H_
+#define PUCKMAN_GRAPHICS_ATLAS_H_
+
+#include <vector>
+#include "../GLUT/glut.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	/*
+	*  Atlas packer class, copies a set of clippings of an image on a smaller image placing them on
+	*  shelves, each clipping gets a border that repeats its edge pixels so the filtering never takes
+	*  pixels from the neighbours
+	*/
+	class CAtlasPacker
+	{
+	public:
+		explicit CAtlasPacker(int padding = 1) : _padding{ padding }, _width{ 0 }, _height{ 0 } {}
+		~CAtlasPacker() = default;
+
+		// place the clippings on the smallest atlas, powerOfTwo rounds the size of the candidates
+		// up as the texture will need; the clippings without size are left as they are
+		void Pack(const std::vector<LFRect>& clippings, bool powerOfTwo);
+
+		// copy the clippings from the source image to the atlas, both with 32 bits pixels and rows of the given widths
+		void Compose(const std::vector<LFRect>& clippings, const GLuint* source, int sourceWidth, GLuint* atlas, int atlasWidth);
+
+		// position of each clipping on the atlas
+		const std::vector<LFRect>& Placed() { return _placed; }
+		// size of the atlas
+		int Width() { return _width; }
+		int Height() { return _height; }
+
+	private:
+		// place the clippings on shelves of the given width, returns the height used
+		int Shelve(const std::vector<LFRect>& clippings, const std::vector<size_t>& order, int width, std::vector<LFRect>& placed);
+
+		int _padding;
+		std::vector<LFRect> _placed;
+		int _width, _height;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_ATLAS_H_
@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_FONT_H_
+#define PUCKMAN_GRAPHICS_FONT_H_
+
+namespace graphicscore
+{
+	// size in pixels of the characters of the bitmap font, the last row is for the descenders
+	static const int FONT_WIDTH = 5;
+	static const int FONT_HEIGHT = 8;
+	// rows above the baseline
+	static const int FONT_ASCENT = 7;
+
+	// printable ASCII characters of the font, the rest are shown as blanks
+	static const int FONT_FIRST = 32;
+	static const int FONT_LAST = 126;
+
+	// columns of each character, the lowest bit is the top row
+	extern const unsigned char FONT_5X8[FONT_LAST - FONT_FIRST + 1][FONT_WIDTH];
+
+	// check if a pixel of a character is set
+	inline bool FontPixel(char ch, int column, int row)
+	{
+		int index = static_cast<unsigned char>(ch);
+		if (index < FONT_FIRST || index > FONT_LAST)
+			return false;
+		return ((FONT_5X8[index - FONT_FIRST][column] >> row) & 1) != 0;
+	}
+}
+
+#endif // PUCKMAN_GRAPHICS_FONT_H_
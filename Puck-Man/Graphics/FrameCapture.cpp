@@ -0,0 +1,365 @@
+#include <cstdio>
+#include <cstring>
+#include "FrameCapture.h"
+#include "GLExtensions.h"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// pixel buffer objects came with OpenGL 2.1, the headers of Windows only know OpenGL 1.1
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER    0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ          0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY            0x88B8
+#endif
+#ifndef GL_BGRA
+#define GL_BGRA                 0x80E1
+#endif
+
+namespace graphicscore
+{
+	namespace
+	{
+		typedef void (APIENTRY *GenBuffersProc)(GLsizei n, GLuint* buffers);
+		typedef void (APIENTRY *DeleteBuffersProc)(GLsizei n, const GLuint* buffers);
+		typedef void (APIENTRY *BindBufferProc)(GLenum target, GLuint buffer);
+		typedef void (APIENTRY *BufferDataProc)(GLenum target, std::ptrdiff_t size, const void* data, GLenum usage);
+		typedef void* (APIENTRY *MapBufferProc)(GLenum target, GLenum access);
+		typedef GLboolean(APIENTRY *UnmapBufferProc)(GLenum target);
+
+		GenBuffersProc genBuffers;
+		DeleteBuffersProc deleteBuffers;
+		BindBufferProc bindBuffer;
+		BufferDataProc bufferData;
+		MapBufferProc mapBuffer;
+		UnmapBufferProc unmapBuffer;
+
+		const size_t FRAME_BYTES = WINDOW_WIDTH * WINDOW_HEIGHT * 4;
+	}
+
+	CFrameCapture::CFrameCapture() :
+		_source{ ReadbackSource }, _format{ RawCapture }, _readbacks{}, _issued{ 0 }, _collected{ 0 },
+		_slots(CAPTURE_SLOTS), _head{ 0 }, _tail{ 0 }, _written{ 0 }, _dropped{ 0 }, _stop{ false }, _standard{ nullptr },
+		_output{ nullptr }, _console{ nullptr }
+	{
+	}
+
+	CFrameCapture::~CFrameCapture()
+	{
+		// the context may be gone, only the frames that reached the writer are saved
+		if (IsOpen())
+			Finish();
+	}
+
+	bool CFrameCapture::Open(const std::string& path, gamecore::CScenario& scenario, CaptureSource source)
+	{
+		if (IsOpen())
+			Close();
+
+		bool standard = path == "-";
+		if (!standard)
+		{
+			// named pipes are opened like any other file
+			_file.open(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+			if (!_file)
+			{
+#if DEBUG_CONSOLE
+				std::cout << "ERROR: Unable to open the capture file " << path << std::endl;
+#endif
+				return false;
+			}
+		}
+
+		auto extension = path.size() >= 4 ? path.substr(path.size() - 4) : std::string{};
+		_format = (extension == ".y4m" || extension == ".Y4M") ? Y4MCapture : RawCapture;
+
+		_source = source;
+		if (_source == ReadbackSource && !InitReadback())
+		{
+#if DEBUG_CONSOLE
+			std::cout << "ERROR: Pixel buffers not supported, the frames are captured with the software renderer" << std::endl;
+#endif
+			_source = SoftwareSource;
+		}
+		if (_source == SoftwareSource && !_renderer.Init(scenario))
+		{
+			if (!standard)
+				_file.close();
+			return false;
+		}
+
+		for (auto& slot : _slots)
+			slot.pixels.resize(_source == ReadbackSource ? FRAME_BYTES : 0);
+		_buffer.resize(WINDOW_WIDTH * WINDOW_HEIGHT * 3);
+		_head = _tail = _written = _dropped = 0;
+		_issued = _collected = 0;
+		_stop = false;
+
+		if (standard)
+		{
+			// the frames take the standard output without the translation of the line ends, and the
+			// messages of the console go to the standard error so they don't break the video
+#if defined(_WIN32)
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			_standard.rdbuf(std::cout.rdbuf());
+			_console = std::cout.rdbuf(std::cerr.rdbuf());
+			_output = &_standard;
+		}
+		else
+			_output = &_file;
+		if (_format == Y4MCapture)
+			*_output << "YUV4MPEG2 W" << WINDOW_WIDTH << " H" << WINDOW_HEIGHT << " F" << CAPTURE_FPS
+				<< ":1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+		_writer = std::thread(&CFrameCapture::Write, this);
+
+#if DEBUG_CONSOLE
+		std::cout << "Capturing " << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << (_format == Y4MCapture ? " Y4M" : " RGB")
+			<< " frames to " << (standard ? "the standard output" : path) << (_source == ReadbackSource ? " from OpenGL" : " from the software renderer") << std::endl;
+#endif
+		return true;
+	}
+
+	bool CFrameCapture::InitReadback()
+	{
+		// they are part of the core since OpenGL 2.1, before that they come with an extension
+		bool supported = HasGLVersion(2, 1) || HasGLExtension("GL_ARB_pixel_buffer_object");
+		if (!supported || !LoadGLProc(genBuffers, "glGenBuffers", "ARB") || !LoadGLProc(deleteBuffers, "glDeleteBuffers", "ARB") ||
+			!LoadGLProc(bindBuffer, "glBindBuffer", "ARB") || !LoadGLProc(bufferData, "glBufferData", "ARB") ||
+			!LoadGLProc(mapBuffer, "glMapBuffer", "ARB") || !LoadGLProc(unmapBuffer, "glUnmapBuffer", "ARB"))
+			return false;
+
+		genBuffers(CAPTURE_READBACKS, _readbacks);
+		for (auto readback : _readbacks)
+		{
+			bindBuffer(GL_PIXEL_PACK_BUFFER, readback);
+			bufferData(GL_PIXEL_PACK_BUFFER, FRAME_BYTES, nullptr, GL_STREAM_READ);
+		}
+		bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		return true;
+	}
+
+	/*
+	*  capture the frame painted on the current buffer
+	*/
+	void CFrameCapture::Grab(gamecore::GameFrame& frame, GLfloat alpha, bool paused)
+	{
+		if (!IsOpen())
+			return;
+
+		// the writer paints the frame again on its own thread
+		if (_source == SoftwareSource)
+		{
+			if (Slot* slot = Reserve())
+			{
+				slot->frame = frame;
+				slot->alpha = alpha;
+				slot->paused = paused;
+				Submit();
+			}
+			return;
+		}
+
+		// the buffer about to be reused was read CAPTURE_READBACKS frames ago, it's finished by now
+		unsigned int readback = _issued % CAPTURE_READBACKS;
+		if (_issued - _collected == CAPTURE_READBACKS)
+			Collect(readback);
+
+		// with a pixel buffer bound the read returns at once and the copy goes on in the background,
+		// BGRA is the layout of the framebuffer on most drivers so nothing is converted
+		bindBuffer(GL_PIXEL_PACK_BUFFER, _readbacks[readback]);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+		bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		++_issued;
+	}
+
+	void CFrameCapture::Collect(unsigned int readback)
+	{
+		bindBuffer(GL_PIXEL_PACK_BUFFER, _readbacks[readback]);
+		auto pixels = static_cast<const uint8_t*>(mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+		if (pixels != nullptr)
+		{
+			if (Slot* slot = Reserve())
+			{
+				std::memcpy(slot->pixels.data(), pixels, FRAME_BYTES);
+				Submit();
+			}
+			unmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		++_collected;
+	}
+
+	void CFrameCapture::Close()
+	{
+		if (!IsOpen())
+			return;
+
+		// collect the frames that are still on the pixel buffers, oldest first
+		if (_source == ReadbackSource)
+		{
+			while (_collected < _issued)
+				Collect(_collected % CAPTURE_READBACKS);
+			deleteBuffers(CAPTURE_READBACKS, _readbacks);
+		}
+
+		Finish();
+#if DEBUG_CONSOLE
+		std::cout << "Capture closed, " << _written << " frames written and " << _dropped << " dropped" << std::endl;
+#endif
+	}
+
+	void CFrameCapture::Finish()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ _mutex };
+			_stop = true;
+		}
+		_pending.notify_one();
+		_writer.join();
+
+		if (_output == &_standard)
+		{
+			std::cout.rdbuf(_console);
+			_console = nullptr;
+		}
+		else
+			_file.close();
+		_output = nullptr;
+	}
+
+	unsigned int CFrameCapture::Written()
+	{
+		std::lock_guard<std::mutex> lock{ _mutex };
+		return _written;
+	}
+
+	unsigned int CFrameCapture::Dropped()
+	{
+		std::lock_guard<std::mutex> lock{ _mutex };
+		return _dropped;
+	}
+
+	CFrameCapture::Slot* CFrameCapture::Reserve()
+	{
+		std::lock_guard<std::mutex> lock{ _mutex };
+		// the render thread never waits for the writer, the frame is lost instead
+		if (_head - _tail == CAPTURE_SLOTS)
+		{
+			++_dropped;
+			return nullptr;
+		}
+		return &_slots[_head % CAPTURE_SLOTS];
+	}
+
+	void CFrameCapture::Submit()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ _mutex };
+			++_head;
+		}
+		_pending.notify_one();
+	}
+
+	/*
+	*  write the frames as they arrive, the ones on the ring are written before stopping
+	*/
+	void CFrameCapture::Write()
+	{
+		for (;;)
+		{
+			Slot* slot;
+			{
+				std::unique_lock<std::mutex> lock{ _mutex };
+				_pending.wait(lock, [this] { return _stop || _tail != _head; });
+				if (_tail == _head)
+					break;
+				slot = &_slots[_tail % CAPTURE_SLOTS];
+			}
+
+			WriteFrame(*slot);
+
+			std::lock_guard<std::mutex> lock{ _mutex };
+			++_tail;
+			++_written;
+		}
+		_output->flush();
+	}
+
+	void CFrameCapture::WriteFrame(Slot& slot)
+	{
+		// the read back comes in BGRA from the bottom row, the software renderer in RGBA from the top row
+		const uint8_t* pixels;
+		int red, blue;
+		ptrdiff_t stride = WINDOW_WIDTH * 4;
+		if (_source == SoftwareSource)
+		{
+			_renderer.Paint(slot.frame, slot.alpha, slot.paused);
+			pixels = reinterpret_cast<const uint8_t*>(_renderer.Pixels().data());
+			red = 0;
+			blue = 2;
+		}
+		else
+		{
+			pixels = slot.pixels.data() + (WINDOW_HEIGHT - 1) * stride;
+			stride = -stride;
+			red = 2;
+			blue = 0;
+		}
+
+		uint8_t* output = _buffer.data();
+		size_t size;
+		if (_format == RawCapture)
+		{
+			size = WINDOW_WIDTH * WINDOW_HEIGHT * 3;
+			for (int y = 0; y < WINDOW_HEIGHT; ++y)
+			{
+				const uint8_t* row = pixels + y * stride;
+				for (int x = 0; x < WINDOW_WIDTH; ++x, row += 4)
+				{
+					*output++ = row[red];
+					*output++ = row[1];
+					*output++ = row[blue];
+				}
+			}
+		}
+		else
+		{
+			// BT.601 with limited range, the chroma takes the average of each block of 2x2 pixels
+			size = WINDOW_WIDTH * WINDOW_HEIGHT * 3 / 2;
+			uint8_t* luma = output;
+			uint8_t* cb = luma + WINDOW_WIDTH * WINDOW_HEIGHT;
+			uint8_t* cr = cb + (WINDOW_WIDTH / 2) * (WINDOW_HEIGHT / 2);
+			for (int y = 0; y < WINDOW_HEIGHT; ++y)
+			{
+				const uint8_t* row = pixels + y * stride;
+				for (int x = 0; x < WINDOW_WIDTH; ++x, row += 4)
+					*luma++ = static_cast<uint8_t>(((66 * row[red] + 129 * row[1] + 25 * row[blue] + 128) >> 8) + 16);
+			}
+			for (int y = 0; y < WINDOW_HEIGHT; y += 2)
+			{
+				const uint8_t* top = pixels + y * stride;
+				const uint8_t* bottom = top + stride;
+				for (int x = 0; x < WINDOW_WIDTH; x += 2, top += 8, bottom += 8)
+				{
+					int r = (top[red] + top[red + 4] + bottom[red] + bottom[red + 4] + 2) >> 2;
+					int g = (top[1] + top[5] + bottom[1] + bottom[5] + 2) >> 2;
+					int b = (top[blue] + top[blue + 4] + bottom[blue] + bottom[blue + 4] + 2) >> 2;
+					// the offset of 128 goes in before the shift so it never shifts a negative number
+					*cb++ = static_cast<uint8_t>((-38 * r - 74 * g + 112 * b + 32896) >> 8);
+					*cr++ = static_cast<uint8_t>((112 * r - 94 * g - 18 * b + 32896) >> 8);
+				}
+			}
+			*_output << "FRAME\n";
+		}
+
+		_output->write(reinterpret_cast<const char*>(_buffer.data()), size);
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_FRAMECAPTURE_H_
+#define PUCKMAN_GRAPHICS_FRAMECAPTURE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SoftwareRenderer.h"
+#include "../GLUT/glut.h"
+#include "../Game/Frame.h"
+#include "../Game/Scenario.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	// rate written on the header of the videos, a frame is written for each frame shown on screen
+	static const unsigned int CAPTURE_FPS = 60;
+	// pixel buffers read back by OpenGL, a frame is copied when the buffer comes back around so the
+	// transfer has two frames to finish without stalling
+	static const unsigned int CAPTURE_READBACKS = 3;
+	// frames waiting for the writer, when all of them are taken the new frames are dropped
+	static const unsigned int CAPTURE_SLOTS = 8;
+
+	// format of the captured video, taken from the extension of the file
+	const enum CaptureFormat
+	{
+		// RGB bytes of each pixel, top row first, with no header
+		RawCapture,
+		// YUV4MPEG2 with 4:2:0 chroma
+		Y4MCapture
+	};
+
+	// source of the captured pixels
+	const enum CaptureSource
+	{
+		// read back the frame painted by OpenGL through pixel buffer objects
+		ReadbackSource,
+		// paint the frame again with the software renderer on the writer thread
+		SoftwareSource
+	};
+
+	/*
+	*  Frame capture class, streams every frame shown on screen to a file or a pipe from a background
+	*  thread, the render thread only starts the transfer of the pixels and copies a finished one
+	*/
+	class CFrameCapture
+	{
+	public:
+		CFrameCapture();
+		~CFrameCapture();
+
+		// open the output ("-" writes to the standard output) and prepare the source, the OpenGL context
+		// must be current; the read back falls back to the software renderer without pixel buffers
+		bool Open(const std::string& path, gamecore::CScenario& scenario, CaptureSource source = ReadbackSource);
+		// the capture is running
+		bool IsOpen() { return _output != nullptr; }
+
+		// capture the frame just painted, it must be called before swapping the buffers
+		void Grab(gamecore::GameFrame& frame, GLfloat alpha, bool paused);
+
+		// write the frames on their way and close the output, the OpenGL context must be current
+		void Close();
+
+		// source of the pixels and format of the output
+		CaptureSource Source() { return _source; }
+		CaptureFormat Format() { return _format; }
+		// frames written and frames dropped because the writer was behind, since the capture was opened
+		unsigned int Written();
+		unsigned int Dropped();
+
+	private:
+		// frame waiting for the writer
+		struct Slot
+		{
+			// RGBA pixels, bottom row first when they come from OpenGL
+			std::vector<uint8_t> pixels;
+			// copy of the frame for the software renderer
+			gamecore::GameFrame frame;
+			GLfloat alpha;
+			bool paused;
+		};
+
+		// load the entry points of the pixel buffers, false if the context doesn't have them
+		bool InitReadback();
+		// copy a finished read back to the writer
+		void Collect(unsigned int readback);
+		// take a free slot, nullptr when the writer is behind
+		Slot* Reserve();
+		// hand the reserved slot to the writer
+		void Submit();
+
+		// method executed by the writer thread
+		void Write();
+		// write a frame with the selected format
+		void WriteFrame(Slot& slot);
+		// stop the writer and release the output
+		void Finish();
+
+		CaptureSource _source;
+		CaptureFormat _format;
+		CSoftwareRenderer _renderer;
+
+		// pixel buffers of the read back and number of frames read into them
+		GLuint _readbacks[CAPTURE_READBACKS];
+		unsigned long long _issued;
+		unsigned long long _collected;
+
+		// ring of frames, the render thread fills them at _head and the writer empties them at _tail
+		std::vector<Slot> _slots;
+		unsigned int _head;
+		unsigned int _tail;
+		unsigned int _written;
+		unsigned int _dropped;
+		bool _stop;
+		std::mutex _mutex;
+		std::condition_variable _pending;
+		std::thread _writer;
+
+		// file or standard output, and the rows converted before writing them
+		std::ofstream _file;
+		std::ostream _standard;
+		std::ostream* _output;
+		std::vector<uint8_t> _buffer;
+		// buffer that std::cout had before the frames took the standard output
+		std::streambuf* _console;
+
+		/* remove these features to avoid copies of the thread */
+		// remove the copy constructor
+		CFrameCapture(const CFrameCapture& src) = delete;
+		// remove the copy assign operator
+		const CFrameCapture& operator=(const CFrameCapture& rhs) = delete;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_FRAMECAPTURE_H_
@@ -0,0 +1,126 @@
+#include "GLBackends.h"
+#include "../Game/Scenario.h"
+
+namespace graphicscore
+{
+	bool CImmediateBackend::Init(gamecore::CScenario& scenario)
+	{
+		if (scenario.Data().Texture().ID() == 0)
+		{
+#if DEBUG_CONSOLE
+			std::cout << "ERROR: The texture of the sprites must be loaded before the OpenGL backend" << std::endl;
+#endif
+			return false;
+		}
+
+		_data = &scenario.Data();
+		return true;
+	}
+
+	void CImmediateBackend::Clear()
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+
+	void CImmediateBackend::DrawLayer()
+	{
+		_data->RenderLayer();
+		++_drawCalls;
+	}
+
+	void CImmediateBackend::DrawSprite(GLfloat x, GLfloat y, Clipping clip)
+	{
+		_data->RenderTexture(x, y, &_data->Clippings(clip));
+		++_drawCalls;
+	}
+
+	void CImmediateBackend::DrawQuad(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, GLfloat alpha)
+	{
+		// remove any previous transformations
+		glLoadIdentity();
+		glColor4f(colors[color].r, colors[color].g, colors[color].b, alpha);
+		glBegin(GL_QUADS);
+		glVertex2f(x, y);
+		glVertex2f(x + width, y);
+		glVertex2f(x + width, y + height);
+		glVertex2f(x, y + height);
+		glEnd();
+		// the textures are modulated by the current color, leave it white for them
+		glColor4f(1.f, 1.f, 1.f, 1.f);
+		++_drawCalls;
+	}
+
+	void CImmediateBackend::DrawQuads(const CQuadLayer& layer)
+	{
+		if (layer.Empty())
+			return;
+
+		layer.Draw();
+		++_drawCalls;
+	}
+
+	void CImmediateBackend::DrawString(int x, int y, const char* text, TextSize size, Color color)
+	{
+		// the glyphs are on the atlas of the sprites, the whole text goes in a single draw call
+		AddString(x, y, text, size, color);
+		_data->Batch().Flush();
+		++_drawCalls;
+	}
+
+	void CImmediateBackend::AddString(int x, int y, const char* text, TextSize size, Color color)
+	{
+		const TextRun& run = _texts.Layout(text, size);
+		GLfloat left = static_cast<GLfloat>(x - run.width / 2);
+		GLfloat top = static_cast<GLfloat>(y - TextAscent(size));
+		GLuint rgba = ColorRGBA(color);
+		for (auto& glyph : run.glyphs)
+			_data->Batch().Draw(left + glyph.x, top + glyph.y, glyph.clip, rgba);
+	}
+
+	void CBatchedBackend::Begin()
+	{
+		CImmediateBackend::Begin();
+		_data->Batch().Begin();
+	}
+
+	/* everything that doesn't go through the batch draws the sprites and texts collected before it,
+	   so the order of the scene is kept */
+
+	void CBatchedBackend::DrawLayer()
+	{
+		Flush();
+		CImmediateBackend::DrawLayer();
+	}
+
+	void CBatchedBackend::DrawSprite(GLfloat x, GLfloat y, Clipping clip)
+	{
+		_data->Batch().Draw(x, y, clip);
+	}
+
+	void CBatchedBackend::DrawQuad(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, GLfloat alpha)
+	{
+		Flush();
+		CImmediateBackend::DrawQuad(x, y, width, height, color, alpha);
+	}
+
+	void CBatchedBackend::DrawQuads(const CQuadLayer& layer)
+	{
+		Flush();
+		CImmediateBackend::DrawQuads(layer);
+	}
+
+	void CBatchedBackend::DrawString(int x, int y, const char* text, TextSize size, Color color)
+	{
+		AddString(x, y, text, size, color);
+	}
+
+	void CBatchedBackend::Flush()
+	{
+		_data->Batch().Flush();
+	}
+
+	unsigned int CBatchedBackend::DrawCalls()
+	{
+		return _drawCalls + _data->Batch().DrawCalls();
+	}
+}
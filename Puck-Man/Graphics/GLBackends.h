@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_GLBACKENDS_H_
+#define PUCKMAN_GRAPHICS_GLBACKENDS_H_
+
+#include "RenderBackend.h"
+#include "Textures.h"
+#include "../GLUT/glut.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	/*
+	*  Immediate backend class, paints each command with its own OpenGL draw call as soon as it arrives
+	*/
+	class CImmediateBackend : public CRenderBackend
+	{
+	public:
+		CImmediateBackend() : _data{ nullptr } {}
+
+		BackendType Type() override { return ImmediateBackend; }
+		bool Init(gamecore::CScenario& scenario) override;
+
+		void Clear() override;
+		void DrawLayer() override;
+		void DrawSprite(GLfloat x, GLfloat y, Clipping clip) override;
+		void DrawQuad(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, GLfloat alpha) override;
+		void DrawQuads(const CQuadLayer& layer) override;
+		void DrawString(int x, int y, const char* text, TextSize size, Color color) override;
+
+	protected:
+		// sprites and layer of the scenario
+		CData* _data;
+
+		// add the glyphs of a text to the sprite batch, centered around x with its baseline on y
+		void AddString(int x, int y, const char* text, TextSize size, Color color);
+	};
+
+	/*
+	*  Batched backend class, collects the sprites and texts on the sprite batch of the scenario and draws them
+	*  together when something else has to be painted or the frame is finished
+	*/
+	class CBatchedBackend : public CImmediateBackend
+	{
+	public:
+		BackendType Type() override { return BatchedBackend; }
+
+		void Begin() override;
+		void DrawLayer() override;
+		void DrawSprite(GLfloat x, GLfloat y, Clipping clip) override;
+		void DrawQuad(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, GLfloat alpha) override;
+		void DrawQuads(const CQuadLayer& layer) override;
+		void DrawString(int x, int y, const char* text, TextSize size, Color color) override;
+		void Flush() override;
+
+		unsigned int DrawCalls() override;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_GLBACKENDS_H_
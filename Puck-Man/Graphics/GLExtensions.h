@@ -0,0 +1,51 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_GLEXTENSIONS_H_
+#define PUCKMAN_GRAPHICS_GLEXTENSIONS_H_
+
+#include <cstring>
+#include <string>
+#include "../GLUT/glut.h"
+
+// the headers of Windows only know OpenGL 1.1, the newer functions are looked up on the context
+#if defined(_WIN32)
+#define GetGLProcAddress(name)  wglGetProcAddress(name)
+#else
+#include <GL/glx.h>
+#define GetGLProcAddress(name)  glXGetProcAddressARB(reinterpret_cast<const GLubyte*>(name))
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#endif
+
+namespace graphicscore
+{
+	// take the core entry point of a function or, when the context doesn't have it, the one of the
+	// extension with the given suffix (ARB, EXT)
+	template<typename Proc>
+	bool LoadGLProc(Proc& proc, const char* name, const char* suffix)
+	{
+		proc = reinterpret_cast<Proc>(GetGLProcAddress(name));
+		if (proc == nullptr)
+			proc = reinterpret_cast<Proc>(GetGLProcAddress((std::string{ name } + suffix).c_str()));
+		return proc != nullptr;
+	}
+
+	// check if the version of the current context is at least the given one
+	inline bool HasGLVersion(int major, int minor)
+	{
+		const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+		if (version == nullptr || version[0] < '1' || version[0] > '9')
+			return false;
+		return version[0] - '0' > major || (version[0] - '0' == major && version[2] - '0' >= minor);
+	}
+
+	// check if the current context has an extension
+	inline bool HasGLExtension(const char* name)
+	{
+		const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+		return extensions != nullptr && std::strstr(extensions, name) != nullptr;
+	}
+}
+
+#endif // PUCKMAN_GRAPHICS_GLEXTENSIONS_H_
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstdlib>
+#include "Golden.h"
+#include "SoftwareRenderer.h"
+#include "../DevIL/il.h"
+#include "../Game/VectorEnv.h"
+
+namespace graphicscore
+{
+	namespace
+	{
+		// states covered by the golden images: the start of a game, Pacman and the ghosts on whole
+		// tiles and between them, and the pause message
+		const GoldenState GOLDEN_STATES[] =
+		{
+			{ "start",   1,   0, 1.f,  false },
+			{ "running", 1,  20, 1.f,  false },
+			{ "between", 1,   9, 0.5f, false },
+			{ "paused",  2,  60, 1.f,  true  },
+		};
+
+		// direction given on each tick, it turns every few tiles so the characters spread over the maze
+		inline uint8_t GoldenAction(unsigned int tick)
+		{
+			static const uint8_t directions[] = { gamecore::Left, gamecore::Up, gamecore::Right, gamecore::Down };
+			return directions[(tick / 24) % 4];
+		}
+	}
+
+	bool CGoldenImages::Run(bool record)
+	{
+		// a single world is enough, the states are painted one after the other; the maze is always
+		// the description of the level, a compiled one may be older than it
+		gamecore::CVectorEnv env{ 1, 1 };
+		if (!env.Init(0, false) || !env.InitRendering())
+			return false;
+
+		CSoftwareRenderer renderer;
+		if (!renderer.Init(env.Scenario()))
+			return false;
+
+		std::vector<uint8_t> observation(gamecore::CVectorEnv::OBSERVATION_SIZE);
+		std::vector<uint8_t> pixels(WINDOW_WIDTH * WINDOW_HEIGHT * 3);
+		float reward;
+		uint8_t done;
+		int failed = 0;
+
+		for (auto& state : GOLDEN_STATES)
+		{
+			env.World(0).Seed(state.seed);
+			env.Reset(observation.data());
+			for (unsigned int tick = 0; tick < state.ticks; ++tick)
+			{
+				uint8_t action = GoldenAction(tick);
+				env.Step(&action, observation.data(), &reward, &done);
+			}
+
+			gamecore::GameFrame frame;
+			frame.Capture(env.World(0));
+			renderer.Paint(frame, state.alpha, state.paused);
+
+			// the alpha of the framebuffer never reaches the screen, only the colors are kept
+			auto& painted = renderer.Pixels();
+			for (size_t i = 0; i < painted.size(); ++i)
+			{
+				pixels[i * 3] = static_cast<uint8_t>(painted[i]);
+				pixels[i * 3 + 1] = static_cast<uint8_t>(painted[i] >> 8);
+				pixels[i * 3 + 2] = static_cast<uint8_t>(painted[i] >> 16);
+			}
+
+			if (record)
+			{
+				if (!Save(_directory + "/" + state.name + ".png", pixels))
+					++failed;
+				else
+					std::cout << "Golden " << state.name << ": recorded" << std::endl;
+			}
+			else if (!Compare(state.name, pixels))
+				++failed;
+		}
+
+		std::cout << "Golden images: " << (sizeof(GOLDEN_STATES) / sizeof(GOLDEN_STATES[0]) - failed) << " of "
+			<< sizeof(GOLDEN_STATES) / sizeof(GOLDEN_STATES[0]) << (record ? " recorded" : " passed") << std::endl;
+		return failed == 0;
+	}
+
+	bool CGoldenImages::Compare(const std::string& name, const std::vector<uint8_t>& pixels)
+	{
+		std::string base = _directory + "/" + name;
+		std::vector<uint8_t> golden;
+		if (!Load(base + ".png", golden))
+		{
+			std::cout << "Golden " << name << ": FAILED, there is no golden image (run with --golden-record)" << std::endl;
+			return false;
+		}
+
+		// the pixels out of the tolerance are marked red over a dim copy of the picture
+		std::vector<uint8_t> differences(pixels.size());
+		int failing = 0, largest = 0;
+		for (size_t i = 0; i < pixels.size(); i += 3)
+		{
+			int difference = 0;
+			for (int c = 0; c < 3; ++c)
+				difference = std::max(difference, std::abs(pixels[i + c] - golden[i + c]));
+			largest = std::max(largest, difference);
+
+			bool fails = difference > GOLDEN_TOLERANCE;
+			failing += fails ? 1 : 0;
+			for (int c = 0; c < 3; ++c)
+				differences[i + c] = fails ? (c == 0 ? 255 : 0) : static_cast<uint8_t>(pixels[i + c] / 4);
+		}
+
+		if (failing <= GOLDEN_MAX_PIXELS)
+		{
+			std::cout << "Golden " << name << ": passed (" << failing << " pixels out of the tolerance, largest difference " << largest << ")" << std::endl;
+			return true;
+		}
+
+		Save(base + ".actual.png", pixels);
+		Save(base + ".diff.png", differences);
+		std::cout << "Golden " << name << ": FAILED, " << failing << " pixels differ (largest difference " << largest
+			<< "), see " << base << ".actual.png and " << base << ".diff.png" << std::endl;
+		return false;
+	}
+
+	bool CGoldenImages::Save(const std::string& filename, const std::vector<uint8_t>& pixels)
+	{
+		ILuint image = 0;
+		ilGenImages(1, &image);
+		ilBindImage(image);
+
+		// the rows are given top first, as PNG stores them
+		bool saved = ilTexImage(WINDOW_WIDTH, WINDOW_HEIGHT, 1, 3, IL_RGB, IL_UNSIGNED_BYTE, const_cast<uint8_t*>(pixels.data())) == IL_TRUE;
+		if (saved)
+		{
+			ilRegisterOrigin(IL_ORIGIN_UPPER_LEFT);
+			ilEnable(IL_FILE_OVERWRITE);
+			saved = ilSaveImage(filename.c_str()) == IL_TRUE;
+		}
+		ilDeleteImages(1, &image);
+
+#if DEBUG_CONSOLE
+		if (!saved)
+			std::cout << "ERROR: Unable to save the image: " << filename << std::endl;
+#endif
+		return saved;
+	}
+
+	bool CGoldenImages::Load(const std::string& filename, std::vector<uint8_t>& pixels)
+	{
+		ILuint image = 0;
+		ilGenImages(1, &image);
+		ilBindImage(image);
+
+		bool loaded = ilLoadImage(filename.c_str()) == IL_TRUE && ilConvertImage(IL_RGB, IL_UNSIGNED_BYTE) == IL_TRUE &&
+			ilGetInteger(IL_IMAGE_WIDTH) == WINDOW_WIDTH && ilGetInteger(IL_IMAGE_HEIGHT) == WINDOW_HEIGHT;
+		if (loaded)
+		{
+			const uint8_t* data = ilGetData();
+			pixels.assign(data, data + WINDOW_WIDTH * WINDOW_HEIGHT * 3);
+		}
+		ilDeleteImages(1, &image);
+		return loaded;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_GOLDEN_H_
+#define PUCKMAN_GRAPHICS_GOLDEN_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	// folder with the golden images, next to the scenario files
+	static const char* const GOLDEN_DIRECTORY = "Goldens";
+	// largest difference of a channel that is still taken as equal
+	static const int GOLDEN_TOLERANCE = 2;
+	// pixels out of the tolerance allowed before an image fails
+	static const int GOLDEN_MAX_PIXELS = 16;
+
+	// game state painted for a golden image, the world is stepped from its initial state with a
+	// fixed sequence of directions
+	struct GoldenState
+	{
+		const char* name;
+		unsigned int seed;
+		unsigned int ticks;
+		// interpolation between the last two ticks
+		GLfloat alpha;
+		bool paused;
+	};
+
+	/*
+	*  Golden images class, paints a set of fixed game states with the software renderer (no window
+	*  or GPU needed) and compares them with the images stored on a folder, or stores them; the
+	*  images that fail leave the picture painted and a map of the differences next to the golden one
+	*/
+	class CGoldenImages
+	{
+	public:
+		CGoldenImages(std::string directory = GOLDEN_DIRECTORY) : _directory{ directory } {}
+		~CGoldenImages() = default;
+
+		// paint every state and compare it with its golden image, or replace the golden images
+		// when recording; returns false if any image is missing or differs
+		bool Run(bool record);
+
+	private:
+		// compare a painted state with its golden image, writing the picture and the differences when it fails
+		bool Compare(const std::string& name, const std::vector<uint8_t>& pixels);
+
+		// save and load an image of WINDOW_WIDTH x WINDOW_HEIGHT RGB pixels, top row first
+		static bool Save(const std::string& filename, const std::vector<uint8_t>& pixels);
+		static bool Load(const std::string& filename, std::vector<uint8_t>& pixels);
+
+		std::string _directory;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_GOLDEN_H_
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Graphics.h"
 
 #define Game        CGame::Instance()
@@ -28,19 +29,33 @@ namespace graphicscore
 		// GLUT initialization
 		glutInit(&argc, argv);
 		delete[] buffer;
-		// use double buffer and RGBA color schema
-		glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA);
+		// use double buffer and RGBA color schema, the incremental mode needs the previous frame
+		// so it paints on a single buffer
+		glutInitDisplayMode((_incremental ? GLUT_SINGLE : GLUT_DOUBLE) | GLUT_RGBA);
+		// the upscaled scene starts with the largest whole scale that leaves some room on the screen
+		if (_upscaled)
+		{
+			int scale = CRenderTarget::Scale(glutGet(GLUT_SCREEN_WIDTH) * 7 / 8, glutGet(GLUT_SCREEN_HEIGHT) * 7 / 8);
+			_windowWidth = WINDOW_WIDTH * scale;
+			_windowHeight = WINDOW_HEIGHT * scale;
+		}
 		// center the game window on the screen
-		glutInitWindowPosition((glutGet(GLUT_SCREEN_WIDTH) - WINDOW_WIDTH) >> 1, (glutGet(GLUT_SCREEN_HEIGHT) - WINDOW_HEIGHT) >> 1);
+		glutInitWindowPosition((glutGet(GLUT_SCREEN_WIDTH) - _windowWidth) >> 1, (glutGet(GLUT_SCREEN_HEIGHT) - _windowHeight) >> 1);
 		// set size of the window
-		glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+		glutInitWindowSize(_windowWidth, _windowHeight);
 		// set title of the window
 		glutCreateWindow("Puck-Man");
 
 		// assign callback to paint the window
 		glutDisplayFunc(CGraphics::paint);
-		// assign callback to the loop method to achieve 60 FPS
-		glutTimerFunc(1000 / SCREEN_FPS, CGraphics::loop, 0);
+		// assign callback to the loop method, it runs the ticks of the game and redraws the
+		// screen as fast as the display allows
+		glutIdleFunc(CGraphics::loop);
+		_lastFrame = std::chrono::steady_clock::now();
+		_report = _lastFrame + std::chrono::seconds(1);
+
+		// assign callback to follow the size of the window
+		glutReshapeFunc(CGraphics::reshape);
 
 		// assign callback to get the key been pressed
 		glutKeyboardFunc(CGraphics::keys);
@@ -48,7 +63,43 @@ namespace graphicscore
 		glutSpecialFunc(CGraphics::special);
 
 		// initialize the game
-		return Game.Init();
+		if (!Game.Init())
+			return false;
+
+		// the software backend paints on memory, a window needs one of the others
+		if (_backendType == SoftwareBackend)
+		{
+#if DEBUG_CONSOLE
+			std::cout << "ERROR: The software backend can't paint on the window" << std::endl;
+#endif
+			return false;
+		}
+		_backend = CRenderBackend::Create(_backendType);
+		if (!_backend || !_backend->Init(Scenario))
+			return false;
+#if DEBUG_CONSOLE
+		std::cout << "Render backend: " << CRenderBackend::Name(_backendType) << std::endl;
+#endif
+
+		// the target needs the context, without framebuffers the scene is stretched over the window
+		if (_upscaled && !_target.Init())
+		{
+#if DEBUG_CONSOLE
+			std::cout << "ERROR: Framebuffer objects not supported, the scene is painted on the window" << std::endl;
+#endif
+			_upscaled = false;
+			glViewport(0, 0, _windowWidth, _windowHeight);
+		}
+
+		// the capture needs the context and the sprites of the scenario
+		return _capturePath.empty() || _capture.Open(_capturePath, Scenario, _captureSource);
+	}
+
+	void CGraphics::MainLoop()
+	{
+		// the world is simulated on its own thread, this one only paints the frames it publishes
+		Game.Start();
+		glutMainLoop();
 	}
 
 	/*
@@ -56,26 +107,65 @@ namespace graphicscore
 	*/
 	void CGraphics::PaintScene()
 	{
-		glClear(GL_COLOR_BUFFER_BIT);
+		using std::chrono::steady_clock;
+		const steady_clock::duration tick = std::chrono::duration_cast<steady_clock::duration>(std::chrono::seconds(1)) / TICKS_PER_SECOND;
 
-		// render scenario map on screen
-		Scenario.RenderMap();
+		auto start = steady_clock::now();
+		auto& frame = Game.Frame();
 
-		// TODO: hack to get the normal color on screen, will solve this later
-		SetColor(WHITE);
+		// show the characters between their last two positions, by the time of the next tick
+		// they reach the current one
+		GLfloat alpha = std::min(1.f, static_cast<GLfloat>((start - frame.time).count()) / tick.count());
+
+		// the target keeps the previous frame like the window does for the incremental mode
+		if (_upscaled)
+			_target.Bind();
+		_backend->Begin();
+
+		bool paused = Game.State() == GamePaused;
+		if (!_incremental)
+		{
+			_backend->Clear();
+			_backend->PaintFrame(Scenario, frame, alpha);
+			_paintedTiles += gamecore::CTileBitmap::TILES;
+		}
+		else
+		{
+			// the window keeps the previous frame, only the tiles changed since the ticks of that
+			// frame are painted again; the pause message goes over everything
+			gamecore::CTileBitmap dirty;
+			if (!_painted || paused || _pausedShown || frame.tick - _paintedTick >= gamecore::DIRTY_HISTORY)
+				dirty.Fill();
+			else
+			{
+				for (unsigned int t = _paintedTick; t != frame.tick + 1; ++t)
+					dirty |= frame.dirty[t % gamecore::DIRTY_HISTORY];
+			}
 
-		// render Pacman on the screen
-		Game.Pacman().Render();
+			glEnable(GL_SCISSOR_TEST);
+			dirty.ForEachRect([&](int x, int y, int width, int height)
+			{
+				// the columns are painted one pixel to the left, the last pixel of the window goes with
+				// the last column and the scissor box starts at the bottom of the window
+				int left = x * SIZE_OF_TILE - 1;
+				int right = (x + width == SCREEN_WIDTH_TILES) ? WINDOW_WIDTH : (x + width) * SIZE_OF_TILE - 1;
+				glScissor(left, WINDOW_HEIGHT - (y + height) * SIZE_OF_TILE, right - left, height * SIZE_OF_TILE);
+				_backend->Clear();
+				_backend->PaintFrame(Scenario, frame, alpha);
+			});
+			glDisable(GL_SCISSOR_TEST);
 
-		// render the Ghosts on the screen
-		for (auto& ghost : Game.Ghosts())
-			ghost.Render();
+			_paintedTiles += dirty.Count();
+			_painted = true;
+			_paintedTick = frame.tick;
+			_pausedShown = paused;
+		}
 
 		// check if the game is paused or not
-		if (Game.State() == GamePaused)
+		if (paused)
 		{
 			// show the pause message
-			PaintText(WINDOW_WIDTH >> 1, (WINDOW_HEIGHT >> 1) + 60, "Pause", SMALL);
+			_backend->PaintPause();
 			// show the cursor on screen
 			glutSetCursor(GLUT_CURSOR_INHERIT);
 		}
@@ -83,29 +173,70 @@ namespace graphicscore
 			// hide the cursor on screen
 			glutSetCursor(GLUT_CURSOR_NONE);
 
-		// paint objects on screen by swapping buffers
-		glutSwapBuffers();
+		// take the frame before it leaves the back buffer
+		if (_capture.IsOpen())
+		{
+			auto grab = steady_clock::now();
+			_capture.Grab(frame, alpha, paused);
+			_captureStats.Add(steady_clock::now() - grab);
+		}
+
+		// show the target on the window, the capture above read it at its own size
+		if (_upscaled)
+			_target.Present(_windowWidth, _windowHeight);
+
+		// paint objects on screen by swapping buffers, the incremental mode paints on a single buffer
+		if (_incremental)
+			glFlush();
+		else
+			glutSwapBuffers();
+
+		auto now = steady_clock::now();
+		_paintStats.Add(now - start);
+		_drawCalls += _backend->DrawCalls();
+		_frameStats.Add(now - _lastFrame);
+		_lastFrame = now;
+
+		if (now >= _report)
+		{
+#if DEBUG_CONSOLE
+			std::cout << "Frames: " << _frameStats << ", paint " << _paintStats;
+			if (_frameStats.Count() != 0)
+				std::cout << ", " << _drawCalls / _frameStats.Count() << " draw calls and "
+					<< _paintedTiles / _frameStats.Count() << " tiles per frame";
+			if (_capture.IsOpen())
+				std::cout << ", capture " << _captureStats << " with " << _capture.Dropped() << " frames dropped";
+			std::cout << std::endl;
+#endif
+			_drawCalls = 0;
+			_paintedTiles = 0;
+			_frameStats.Clear();
+			_paintStats.Clear();
+			_captureStats.Clear();
+			_report = now + std::chrono::seconds(1);
+		}
 	}
 
 	/*
-	*  give the timing to the game
+	*  keep the display busy, the frames are painted as fast as it allows
 	*/
-	void CGraphics::LoopGame(int value)
+	void CGraphics::LoopGame()
 	{
-		// change the game state is it's not paused
-		if (Game.State() != GamePaused)
-		{
-			// move Pacman on the scenario
-			Game.Pacman().Move();
-
-			// move the Ghosts on the scenario
-			for (auto& ghost : Game.Ghosts())
-				ghost.Move();
-		}
-		// trigger the update of the screen
 		glutPostRedisplay();
-		// set the new wait interval to achieve 60 FPS
-		glutTimerFunc(1000 / SCREEN_FPS, CGraphics::loop, value);
+	}
+
+	/*
+	*  follow the size of the window
+	*/
+	void CGraphics::Reshape(int width, int height)
+	{
+		_windowWidth = width;
+		_windowHeight = height;
+
+		// the upscaled scene sets the viewport on each frame, otherwise it's stretched over the window
+		// as GLUT does by default
+		if (!_upscaled)
+			glViewport(0, 0, width, height);
 	}
 
 	/*
@@ -126,10 +257,18 @@ namespace graphicscore
 				Game.State(GameRunning);
 			break;
 		case 'r' | 'R':
-			for (auto& ghost : Game.Ghosts())
-				ghost.Reset();
+			Game.ResetGhosts();
+			break;
+		case 'a':
+		case 'A':
+#if DEBUG_CONSOLE
+			std::cout << "Toggle autopilot" << std::endl;
+#endif
+			Game.Autopiloted(!Game.Autopiloted());
 			break;
 		case EscapeKey:
+			Game.Stop();
+			_capture.Close();
 			exit(0);
 			break;
 		}
@@ -145,54 +284,19 @@ namespace graphicscore
 		{
 			// send the key event to the Pacman object
 		case LeftKey:
-			Game.Pacman().ChangeDirection(gamecore::Left);
+			Game.Steer(gamecore::Left);
 			break;
 		case RightKey:
-			Game.Pacman().ChangeDirection(gamecore::Right);
+			Game.Steer(gamecore::Right);
 			break;
 		case UpKey:
-			Game.Pacman().ChangeDirection(gamecore::Up);
+			Game.Steer(gamecore::Up);
 			break;
 		case DownKey:
-			Game.Pacman().ChangeDirection(gamecore::Down);
+			Game.Steer(gamecore::Down);
 			break;
 		default:
 			break;
 		}
 	}
-
-	void CGraphics::PaintSquare(std::tuple<int, int> location, Color color)
-	{
-		// remove any previous transformations
-		glLoadIdentity();
-		SetColor(color, 0.60f);
-		int x = (std::get<0>(location) * SIZE_OF_TILE) - 1;
-		int y = std::get<1>(location) * SIZE_OF_TILE;
-		glBegin(GL_QUADS);
-		glVertex2f(x, y);
-		glVertex2f(x + SIZE_OF_TILE, y);
-		glVertex2f(x + SIZE_OF_TILE, y + SIZE_OF_TILE);
-		glVertex2f(x, y + SIZE_OF_TILE);
-		glEnd();
-	}
-
-	/*
-	*  paint text on screen
-	*/
-	void CGraphics::PaintText(int x, int y, char *text, TextSize size)
-	{
-		// remove any previous transformations
-		glLoadIdentity();
-		// set text color to white
-		SetColor(WHITE);
-		// translate to the specified coordinates
-		glTranslatef(x - TextOffset(size, text), y, 0.f);
-		// scale the text to the selected size
-		glScalef(TextScale(size), -(TextScale(size)), TextScale(size));
-		// set width of the line to draw the font
-		glLineWidth(2);
-		// paint each character on the screen
-		for (auto ch = text; *ch != '\0'; ch++)
-			glutStrokeCharacter(GLUT_STROKE_ROMAN, *ch);
-	}
 }
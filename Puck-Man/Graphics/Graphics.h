@@ -3,11 +3,18 @@
 #ifndef PUCKMAN_GRAPHICS_GRAPHICS_H_
 #define PUCKMAN_GRAPHICS_GRAPHICS_H_
 
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <windows.h>
 #include "../GLUT/glut.h"
 #include "../DevIL/il.h"
+#include "FrameCapture.h"
+#include "RenderBackend.h"
+#include "RenderTarget.h"
 #include "../Game/Game.h"
+#include "../Common/TimingStats.h"
 #include "../Common/Utils.h"
 
 namespace graphicscore
@@ -30,15 +37,28 @@ namespace graphicscore
 
 		// initialize the game engine
 		bool Init();
-		// execute the glut's main loop
-		void MainLoop() { glutMainLoop(); }
+		// start the simulation and execute the glut's main loop
+		void MainLoop();
 
-		// paint a square on screen
-		void PaintSquare(std::tuple<int, int> location, Color color);
+		// get/set if only the tiles that changed are painted on each frame, it must be set before Init
+		bool Incremental() { return _incremental; }
+		void Incremental(bool incremental) { _incremental = incremental; }
+		// stream the frames shown on screen to a file (.y4m for YUV4MPEG2, raw RGB otherwise), it must be set before Init
+		void Capture(const std::string& path, CaptureSource source) { _capturePath = path; _captureSource = source; }
+
+		// get/set if the scene is painted on an offscreen target of its own size and shown on a resizable
+		// window with the largest whole scale that fits, it must be set before Init
+		bool Upscaled() { return _upscaled; }
+		void Upscaled(bool upscaled) { _upscaled = upscaled; }
+
+		// get/set the backend that paints the frames, it must be set before Init
+		BackendType Backend() { return _backendType; }
+		void Backend(BackendType type) { _backendType = type; }
 
 	private:
-		// disable the creation of objects outside of this class and use the default constructor
-		CGraphics() = default;
+		// disable the creation of objects outside of this class
+		CGraphics() : _captureSource{ ReadbackSource }, _incremental{ false }, _upscaled{ false }, _windowWidth{ WINDOW_WIDTH }, _windowHeight{ WINDOW_HEIGHT },
+			_painted{ false }, _pausedShown{ false }, _paintedTick{ 0 }, _backendType{ BatchedBackend }, _drawCalls{ 0 }, _paintedTiles{ 0 } {}
 		// use default constructor (no parameters)
 		~CGraphics() = default;
 
@@ -54,7 +74,8 @@ namespace graphicscore
 		static void paint() { Instance().PaintScene(); }
 		static void keys(unsigned char key, int x, int y) { Instance().KeyPressed(key, x, y); }
 		static void special(int key, int x, int y) { Instance().SpecialKeyPressed(key, x, y); }
-		static void loop(int value) { Instance().LoopGame(value); }
+		static void loop() { Instance().LoopGame(); }
+		static void reshape(int width, int height) { Instance().Reshape(width, height); }
 
 		// method to paint the scene on screen
 		void PaintScene();
@@ -62,23 +83,41 @@ namespace graphicscore
 		void KeyPressed(unsigned char key, int x, int y);
 		// special keys pressed during execution
 		void SpecialKeyPressed(int key, int x, int y);
-		// method to move things on screen
-		void LoopGame(int);
-
-		// method to set color of an object on screen
-		inline void CGraphics::SetColor(Color color)
-		{
-			glColor3f(colors[color].r, colors[color].g, colors[color].b);
-		}
-
-		// method to set color of an object on screen
-		inline void SetColor(Color color, GLfloat alpha)
-		{
-			glColor4f(colors[color].r, colors[color].g, colors[color].b, alpha);
-		}
-
-		// method to display text on screen
-		void PaintText(int x, int y, char *string, TextSize size);
+		// method to request the frames to the display
+		void LoopGame();
+		// method to follow the size of the window
+		void Reshape(int width, int height);
+
+		// time when the last frame was shown and when the stats were last reported
+		std::chrono::steady_clock::time_point _lastFrame;
+		std::chrono::steady_clock::time_point _report;
+		// time between frames and time taken to paint them on the last second
+		commoncore::CTimingStats _frameStats;
+		commoncore::CTimingStats _paintStats;
+		// capture of the frames and time taken to grab them on the last second
+		CFrameCapture _capture;
+		std::string _capturePath;
+		CaptureSource _captureSource;
+		commoncore::CTimingStats _captureStats;
+		// paint only the changed tiles over the previous frame
+		bool _incremental;
+		// paint on the offscreen target and scale it to the window
+		bool _upscaled;
+		CRenderTarget _target;
+		int _windowWidth;
+		int _windowHeight;
+		// there's a frame on the window, and what it showed
+		bool _painted;
+		bool _pausedShown;
+		unsigned int _paintedTick;
+
+		// backend that receives the sprites, quads and texts of each frame
+		std::unique_ptr<CRenderBackend> _backend;
+		BackendType _backendType;
+
+		// draw calls of the backend and tiles painted on the last second
+		unsigned int _drawCalls;
+		unsigned int _paintedTiles;
 	};
 }
 
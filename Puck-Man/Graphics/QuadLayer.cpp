@@ -0,0 +1,56 @@
+#include "QuadLayer.h"
+
+namespace graphicscore
+{
+	void CQuadLayer::Draw() const
+	{
+		if (_quads.empty())
+			return;
+
+		if (!_compiled)
+			Compile();
+
+		// the vertices are already on screen coordinates
+		glLoadIdentity();
+		glCallList(_list);
+	}
+
+	void CQuadLayer::Compile() const
+	{
+		// interleaved position and color, as read by glVertexPointer/glColorPointer
+		struct Vertex
+		{
+			GLfloat x, y;
+			GLuint color;
+		};
+
+		std::vector<Vertex> vertices;
+		vertices.reserve(_quads.size() * 4);
+		for (auto& quad : _quads)
+		{
+			vertices.push_back(Vertex{ quad.x, quad.y, quad.color });
+			vertices.push_back(Vertex{ quad.x + quad.w, quad.y, quad.color });
+			vertices.push_back(Vertex{ quad.x + quad.w, quad.y + quad.h, quad.color });
+			vertices.push_back(Vertex{ quad.x, quad.y + quad.h, quad.color });
+		}
+
+		// display lists are part of OpenGL 1.1 and keep the vertices on the driver; the client arrays
+		// are read while the list is compiled (their state isn't recorded) so they can be released
+		if (_list == 0)
+			_list = glGenLists(1);
+
+		glNewList(_list, GL_COMPILE);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].x);
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vertices[0].color);
+		glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(vertices.size()));
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		// the textures are modulated by the current color, leave it white for them
+		glColor4f(1.f, 1.f, 1.f, 1.f);
+		glEndList();
+
+		_compiled = true;
+	}
+}
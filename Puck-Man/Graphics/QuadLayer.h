@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_QUADLAYER_H_
+#define PUCKMAN_GRAPHICS_QUADLAYER_H_
+
+#include <vector>
+#include "../GLUT/glut.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	// flat colored rectangle on screen coordinates, the color are RGBA bytes
+	struct ColorQuad
+	{
+		GLfloat x, y;
+		GLfloat w, h;
+		GLuint color;
+	};
+
+	/*
+	*  Quad layer class, keeps a set of colored quads that rarely change (special zones, heatmaps) and
+	*  draws all of them with a single call; OpenGL gets them on a display list that is compiled again
+	*  only after the quads change
+	*/
+	class CQuadLayer
+	{
+	public:
+		CQuadLayer() : _list{ 0 }, _compiled{ false } {}
+		// the display list is left to the context, it may be gone when the layer is destroyed
+		~CQuadLayer() = default;
+
+		// remove every quad
+		void Clear() { _quads.clear(); _compiled = false; }
+		// add a quad, it is blended over what is below it with the alpha of its color
+		void Add(GLfloat x, GLfloat y, GLfloat width, GLfloat height, GLuint color)
+		{
+			_quads.push_back(ColorQuad{ x, y, width, height, color });
+			_compiled = false;
+		}
+
+		// quads of the layer in the order they were added
+		const std::vector<ColorQuad>& Quads() const { return _quads; }
+		bool Empty() const { return _quads.empty(); }
+
+		// draw the quads with OpenGL, compiling them first if they changed; only the thread of the
+		// context draws the layer, the rest of them just read its quads
+		void Draw() const;
+
+	private:
+		// build the display list with the current quads
+		void Compile() const;
+
+		std::vector<ColorQuad> _quads;
+
+		// the display list is a copy of the quads kept by OpenGL
+		mutable GLuint _list;
+		mutable bool _compiled;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_QUADLAYER_H_
@@ -0,0 +1,55 @@
+#include "GLBackends.h"
+#include "RenderBackend.h"
+#include "SoftwareRenderer.h"
+#include "../Game/Frame.h"
+#include "../Game/Scenario.h"
+
+namespace graphicscore
+{
+	std::unique_ptr<CRenderBackend> CRenderBackend::Create(BackendType type)
+	{
+		switch (type)
+		{
+		case ImmediateBackend:
+			return std::unique_ptr<CRenderBackend>{ new CImmediateBackend{} };
+		case BatchedBackend:
+			return std::unique_ptr<CRenderBackend>{ new CBatchedBackend{} };
+		case NullBackend:
+			return std::unique_ptr<CRenderBackend>{ new CNullBackend{} };
+		case SoftwareBackend:
+			return std::unique_ptr<CRenderBackend>{ new CSoftwareRenderer{} };
+		default:
+			return nullptr;
+		}
+	}
+
+	const char* CRenderBackend::Name(BackendType type)
+	{
+		static const char* names[] = { "immediate", "batched", "null", "software" };
+		return type < BackendType_Size ? names[type] : "unknown";
+	}
+
+	/*
+	*  paint a frame of the game, the same scene for every backend
+	*/
+	void CRenderBackend::PaintFrame(gamecore::CScenario& scenario, gamecore::GameFrame& frame, GLfloat alpha)
+	{
+		// map with the pills that remain and the special zones
+		scenario.RenderMap(*this, frame.pills);
+
+		// characters over the map
+		frame.pacman.Render(*this, alpha);
+		for (auto& ghost : frame.ghosts)
+			ghost.Render(*this, alpha);
+
+		Flush();
+	}
+
+	void CRenderBackend::PaintPause()
+	{
+		DrawString(WINDOW_WIDTH >> 1, (WINDOW_HEIGHT >> 1) + 60, "Pause", SMALL, WHITE);
+
+		// the message is painted before the frame is grabbed and shown
+		Flush();
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_RENDERBACKEND_H_
+#define PUCKMAN_GRAPHICS_RENDERBACKEND_H_
+
+#include <memory>
+#include "QuadLayer.h"
+#include "Text.h"
+#include "Textures.h"
+#include "../Common/Utils.h"
+
+namespace gamecore
+{
+	class CScenario;
+	struct GameFrame;
+}
+
+namespace graphicscore
+{
+	// available implementations of the backend
+	const enum BackendType
+	{
+		// OpenGL, a draw call for each command
+		ImmediateBackend,
+		// OpenGL, the sprites go through the sprite batch
+		BatchedBackend,
+		// nothing is painted, to measure the game without its rendering
+		NullBackend,
+		// framebuffer on memory painted by the CPU
+		SoftwareBackend,
+		// element to obtain size of the enumeration
+		BackendType_Size
+	};
+
+	/*
+	*  Render backend class, receives the sprites, quads and texts of the game on screen coordinates
+	*  (origin on the upper left corner) and paints them in the order they are submitted
+	*/
+	class CRenderBackend
+	{
+	public:
+		CRenderBackend() : _drawCalls{ 0 } {}
+		virtual ~CRenderBackend() = default;
+
+		// create a backend of the given type, it must be initialized before using it
+		static std::unique_ptr<CRenderBackend> Create(BackendType type);
+		// name of a type of backend, as given on the command line
+		static const char* Name(BackendType type);
+
+		virtual BackendType Type() = 0;
+
+		// take the sprites and the layer of the walls of a loaded scenario
+		virtual bool Init(gamecore::CScenario& scenario) = 0;
+
+		// start a new frame, it restarts the count of draw calls
+		virtual void Begin() { _drawCalls = 0; }
+		// clear the target (or the active scissor box of OpenGL) to transparent black
+		virtual void Clear() = 0;
+		// paint the layer of the walls over the whole window
+		virtual void DrawLayer() = 0;
+		// paint the sprite of a clipping with its upper left corner on the given position
+		virtual void DrawSprite(GLfloat x, GLfloat y, Clipping clip) = 0;
+		// paint a rectangle of a color
+		virtual void DrawQuad(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, GLfloat alpha) = 0;
+		// paint every quad of a layer, blended like DrawQuad
+		virtual void DrawQuads(const CQuadLayer& layer) = 0;
+		// paint a text centered around x with its baseline on y, the layout of the texts painted on
+		// every frame is cached
+		virtual void DrawString(int x, int y, const char* text, TextSize size, Color color) = 0;
+		// paint the commands that are still pending
+		virtual void Flush() {}
+
+		// draw calls sent to the target since the frame began
+		virtual unsigned int DrawCalls() { return _drawCalls; }
+
+		// paint the map and the characters of a frame
+		void PaintFrame(gamecore::CScenario& scenario, gamecore::GameFrame& frame, GLfloat alpha);
+		// paint the message shown while the game is paused
+		void PaintPause();
+
+	protected:
+		unsigned int _drawCalls;
+		// layout of the last texts painted
+		CTextCache _texts;
+
+	private:
+		/* remove these features to avoid copies of the backends */
+		// remove the copy constructor
+		CRenderBackend(const CRenderBackend& src) = delete;
+		// remove the copy assign operator
+		const CRenderBackend& operator=(const CRenderBackend& rhs) = delete;
+	};
+
+	/*
+	*  Null backend class, drops every command
+	*/
+	class CNullBackend : public CRenderBackend
+	{
+	public:
+		BackendType Type() override { return NullBackend; }
+		bool Init(gamecore::CScenario&) override { return true; }
+
+		void Clear() override {}
+		void DrawLayer() override {}
+		void DrawSprite(GLfloat, GLfloat, Clipping) override {}
+		void DrawQuad(GLfloat, GLfloat, GLfloat, GLfloat, Color, GLfloat) override {}
+		void DrawQuads(const CQuadLayer&) override {}
+		void DrawString(int, int, const char*, TextSize, Color) override {}
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_RENDERBACKEND_H_
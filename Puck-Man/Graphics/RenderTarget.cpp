@@ -0,0 +1,126 @@
+#include <algorithm>
+#include "RenderTarget.h"
+#include "GLExtensions.h"
+#include "Textures.h"
+
+// framebuffer objects came with OpenGL 3.0, the values are the same on the extension
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER           0x8D40
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0     0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE  0x8CD5
+#endif
+
+namespace graphicscore
+{
+	namespace
+	{
+		typedef void (APIENTRY *GenFramebuffersProc)(GLsizei n, GLuint* framebuffers);
+		typedef void (APIENTRY *DeleteFramebuffersProc)(GLsizei n, const GLuint* framebuffers);
+		typedef void (APIENTRY *BindFramebufferProc)(GLenum target, GLuint framebuffer);
+		typedef void (APIENTRY *FramebufferTexture2DProc)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+		typedef GLenum(APIENTRY *CheckFramebufferStatusProc)(GLenum target);
+
+		GenFramebuffersProc genFramebuffers;
+		DeleteFramebuffersProc deleteFramebuffers;
+		BindFramebufferProc bindFramebuffer;
+		FramebufferTexture2DProc framebufferTexture2D;
+		CheckFramebufferStatusProc checkFramebufferStatus;
+	}
+
+	bool CRenderTarget::Init()
+	{
+		bool supported = HasGLVersion(3, 0) || HasGLExtension("GL_EXT_framebuffer_object");
+		if (!supported || !LoadGLProc(genFramebuffers, "glGenFramebuffers", "EXT") || !LoadGLProc(deleteFramebuffers, "glDeleteFramebuffers", "EXT") ||
+			!LoadGLProc(bindFramebuffer, "glBindFramebuffer", "EXT") || !LoadGLProc(framebufferTexture2D, "glFramebufferTexture2D", "EXT") ||
+			!LoadGLProc(checkFramebufferStatus, "glCheckFramebufferStatus", "EXT"))
+			return false;
+
+		// without textures of any size the scene takes the lower left corner of a bigger one
+		bool exact = CTexture::NonPowerOfTwo();
+		_textureWidth = exact ? WINDOW_WIDTH : CTexture::PowerOfTwo(WINDOW_WIDTH);
+		_textureHeight = exact ? WINDOW_HEIGHT : CTexture::PowerOfTwo(WINDOW_HEIGHT);
+
+		// the texture is shown texel by texel
+		glGenTextures(1, &_texture);
+		glBindTexture(GL_TEXTURE_2D, _texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _textureWidth, _textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		genFramebuffers(1, &_framebuffer);
+		bindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+		framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture, 0);
+		bool complete = checkFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		if (!complete)
+		{
+			deleteFramebuffers(1, &_framebuffer);
+			glDeleteTextures(1, &_texture);
+			_framebuffer = _texture = 0;
+			return false;
+		}
+		return true;
+	}
+
+	void CRenderTarget::Bind()
+	{
+		bindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+		glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+	}
+
+	void CRenderTarget::Present(int windowWidth, int windowHeight)
+	{
+		bindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, windowWidth, windowHeight);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// whole pixels of the window, the target is centered on it
+		int scale = Scale(windowWidth, windowHeight);
+		GLfloat width = static_cast<GLfloat>(WINDOW_WIDTH * scale);
+		GLfloat height = static_cast<GLfloat>(WINDOW_HEIGHT * scale);
+		GLfloat left = static_cast<GLfloat>((windowWidth - WINDOW_WIDTH * scale) / 2);
+		GLfloat top = static_cast<GLfloat>((windowHeight - WINDOW_HEIGHT * scale) / 2);
+
+		glMatrixMode(GL_PROJECTION);
+		glPushMatrix();
+		glLoadIdentity();
+		glOrtho(0.0, windowWidth, windowHeight, 0.0, 1.0, -1.0);
+		glMatrixMode(GL_MODELVIEW);
+		glLoadIdentity();
+
+		// the alpha left on the target by the blending must not reach the window
+		glDisable(GL_BLEND);
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, _texture);
+
+		// the first row of the texture is the bottom of the scene
+		GLfloat maxU = static_cast<GLfloat>(WINDOW_WIDTH) / _textureWidth;
+		GLfloat maxV = static_cast<GLfloat>(WINDOW_HEIGHT) / _textureHeight;
+		glBegin(GL_QUADS);
+		glTexCoord2f(0.f, maxV); glVertex2f(left, top);
+		glTexCoord2f(maxU, maxV); glVertex2f(left + width, top);
+		glTexCoord2f(maxU, 0.f); glVertex2f(left + width, top + height);
+		glTexCoord2f(0.f, 0.f); glVertex2f(left, top + height);
+		glEnd();
+
+		glDisable(GL_TEXTURE_2D);
+		glEnable(GL_BLEND);
+
+		glMatrixMode(GL_PROJECTION);
+		glPopMatrix();
+		glMatrixMode(GL_MODELVIEW);
+	}
+
+	int CRenderTarget::Scale(int windowWidth, int windowHeight)
+	{
+		return std::max(1, std::min(windowWidth / WINDOW_WIDTH, windowHeight / WINDOW_HEIGHT));
+	}
+}
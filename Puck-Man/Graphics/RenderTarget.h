@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_RENDERTARGET_H_
+#define PUCKMAN_GRAPHICS_RENDERTARGET_H_
+
+#include "../GLUT/glut.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	/*
+	*  Render target class, offscreen framebuffer of WINDOW_WIDTH x WINDOW_HEIGHT pixels (one pixel per
+	*  pixel of the tiles) where the scene is painted, it's shown on the window scaled by a whole factor
+	*  with the nearest texel so the cost of painting doesn't depend on the size of the window
+	*/
+	class CRenderTarget
+	{
+	public:
+		CRenderTarget() : _framebuffer{ 0 }, _texture{ 0 }, _textureWidth{ 0 }, _textureHeight{ 0 } {}
+		// the framebuffer is left to the context, it may be gone when the target is destroyed
+		~CRenderTarget() = default;
+
+		// create the framebuffer, the OpenGL context must be current; it needs OpenGL 3.0 or the
+		// framebuffer object extension
+		bool Init();
+		bool IsReady() { return _framebuffer != 0; }
+
+		// send the following drawing to the target
+		void Bind();
+		// show the target on the window centered with the largest whole scale that fits, the rest of
+		// the window is cleared to black; the drawing goes to the window afterwards
+		void Present(int windowWidth, int windowHeight);
+
+		// largest whole scale of the target that fits a window, never less than one
+		static int Scale(int windowWidth, int windowHeight);
+
+	private:
+		GLuint _framebuffer;
+		// texture painted by the framebuffer, the scene takes its lower left corner
+		GLuint _texture;
+		GLuint _textureWidth;
+		GLuint _textureHeight;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_RENDERTARGET_H_
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+#include "SoftwareRenderer.h"
+#include "../Game/Scenario.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PUCKMAN_SSE2 1
+#include <emmintrin.h>
+#else
+#define PUCKMAN_SSE2 0
+#endif
+
+namespace graphicscore
+{
+	namespace
+	{
+		// round(value / 255) for the products of two bytes, exact for the whole range
+		inline uint32_t Divide255(uint32_t value)
+		{
+			value += 128;
+			return (value + (value >> 8)) >> 8;
+		}
+
+		inline uint32_t Channel(uint32_t pixel, int channel) { return (pixel >> (channel * 8)) & 0xFF; }
+
+		inline uint32_t Pack(uint32_t r, uint32_t g, uint32_t b, uint32_t a) { return r | (g << 8) | (b << 16) | (a << 24); }
+
+		// pixels whose center falls inside of a rectangle, as OpenGL paints them; the window of OpenGL
+		// grows upwards so a center on the top edge is out and one on the bottom edge is in
+		inline void Coverage(GLfloat x, GLfloat y, GLfloat width, GLfloat height, int& left, int& top, int& right, int& bottom)
+		{
+			left = std::max(0, static_cast<int>(std::ceil(x - 0.5f)));
+			top = std::max(0, static_cast<int>(std::floor(y - 0.5f)) + 1);
+			right = std::min(WINDOW_WIDTH, static_cast<int>(std::ceil(x + width - 0.5f)));
+			bottom = std::min(WINDOW_HEIGHT, static_cast<int>(std::floor(y + height - 0.5f)) + 1);
+		}
+	}
+
+	bool CSoftwareRenderer::Init(gamecore::CScenario& scenario)
+	{
+		if (scenario.Data().Sprites().empty() || scenario.Data().LayerPixels().empty())
+		{
+#if DEBUG_CONSOLE
+			std::cout << "ERROR: The sprites of the scenario must be loaded before the software renderer" << std::endl;
+#endif
+			return false;
+		}
+
+		_scenario = &scenario;
+		_pixels.assign(WINDOW_WIDTH * WINDOW_HEIGHT, 0);
+		return true;
+	}
+
+	void CSoftwareRenderer::Paint(gamecore::GameFrame& frame, GLfloat alpha, bool paused)
+	{
+		Begin();
+		Clear();
+		PaintFrame(*_scenario, frame, alpha);
+		if (paused)
+			PaintPause();
+	}
+
+	void CSoftwareRenderer::Clear()
+	{
+		std::fill(_pixels.begin(), _pixels.end(), 0u);
+	}
+
+	void CSoftwareRenderer::DrawLayer()
+	{
+		const uint32_t* layer = _scenario->Data().LayerPixels().data();
+		BlendRow(_pixels.data(), layer, WINDOW_WIDTH * WINDOW_HEIGHT);
+	}
+
+	void CSoftwareRenderer::DrawSprite(GLfloat x, GLfloat y, Clipping clip)
+	{
+		auto& data = _scenario->Data();
+		const LFRect& rect = data.Clippings(clip);
+		const uint32_t* sprites = data.Sprites().data();
+		int stride = data.SpritesWidth();
+		int w = static_cast<int>(rect.w), h = static_cast<int>(rect.h);
+
+		int left, top, right, bottom;
+		Coverage(x, y, static_cast<GLfloat>(w), static_cast<GLfloat>(h), left, top, right, bottom);
+		if (left >= right || top >= bottom)
+			return;
+
+		// on whole pixels each pixel takes a single texel, whole rows can be blended at once
+		if (x == std::floor(x) && y == std::floor(y))
+		{
+			int sx = static_cast<int>(rect.x) + left - static_cast<int>(x);
+			int sy = static_cast<int>(rect.y) + top - static_cast<int>(y);
+			for (int row = top; row < bottom; ++row, ++sy)
+				BlendRow(&_pixels[row * WINDOW_WIDTH + left], &sprites[sy * stride + sx], right - left);
+			return;
+		}
+
+		// between pixels the four nearest texels are mixed, the atlas repeats the edges of each
+		// clipping around it so they never take pixels from other sprites
+		for (int row = top; row < bottom; ++row)
+		{
+			GLfloat ty = rect.y + (row + 0.5f - y) - 0.5f;
+			int y0 = static_cast<int>(std::floor(ty));
+			GLfloat fy = ty - y0;
+			for (int column = left; column < right; ++column)
+			{
+				GLfloat tx = rect.x + (column + 0.5f - x) - 0.5f;
+				int x0 = static_cast<int>(std::floor(tx));
+				GLfloat fx = tx - x0;
+
+				uint32_t t00 = sprites[y0 * stride + x0], t10 = sprites[y0 * stride + x0 + 1];
+				uint32_t t01 = sprites[(y0 + 1) * stride + x0], t11 = sprites[(y0 + 1) * stride + x0 + 1];
+
+				uint32_t channels[4];
+				for (int c = 0; c < 4; ++c)
+				{
+					GLfloat value = (Channel(t00, c) * (1.f - fx) + Channel(t10, c) * fx) * (1.f - fy) +
+						(Channel(t01, c) * (1.f - fx) + Channel(t11, c) * fx) * fy;
+					channels[c] = static_cast<uint32_t>(value + 0.5f);
+				}
+
+				uint32_t& pixel = _pixels[row * WINDOW_WIDTH + column];
+				pixel = Blend(pixel, Pack(channels[0], channels[1], channels[2], channels[3]));
+			}
+		}
+	}
+
+	void CSoftwareRenderer::DrawQuad(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, GLfloat alpha)
+	{
+		int left, top, right, bottom;
+		Coverage(x, y, width, height, left, top, right, bottom);
+		FillRect(left, top, right, bottom, ColorRGBA(color, alpha));
+	}
+
+	void CSoftwareRenderer::DrawQuads(const CQuadLayer& layer)
+	{
+		for (auto& quad : layer.Quads())
+		{
+			int left, top, right, bottom;
+			Coverage(quad.x, quad.y, quad.w, quad.h, left, top, right, bottom);
+			FillRect(left, top, right, bottom, quad.color);
+		}
+	}
+
+	void CSoftwareRenderer::DrawString(int x, int y, const char* text, TextSize size, Color color)
+	{
+		const TextRun& run = _texts.Layout(text, size);
+		int left = x - run.width / 2;
+		int top = y - TextAscent(size);
+		uint32_t tint = ColorRGBA(color);
+
+		// the glyphs sit on whole pixels, each texel of the atlas is tinted like the color array of
+		// the batch does it
+		auto& data = _scenario->Data();
+		const uint32_t* sprites = data.Sprites().data();
+		int stride = data.SpritesWidth();
+		for (auto& glyph : run.glyphs)
+		{
+			const LFRect& rect = data.Clippings(glyph.clip);
+			int gx = left + glyph.x, gy = top + glyph.y;
+			int right = std::min(gx + static_cast<int>(rect.w), WINDOW_WIDTH);
+			int bottom = std::min(gy + static_cast<int>(rect.h), WINDOW_HEIGHT);
+			for (int row = std::max(gy, 0); row < bottom; ++row)
+			{
+				const uint32_t* texels = &sprites[(static_cast<int>(rect.y) + row - gy) * stride + static_cast<int>(rect.x) - gx];
+				for (int column = std::max(gx, 0); column < right; ++column)
+				{
+					uint32_t texel = texels[column];
+					uint32_t& pixel = _pixels[row * WINDOW_WIDTH + column];
+					pixel = Blend(pixel, Pack(Divide255(Channel(texel, 0) * Channel(tint, 0)), Divide255(Channel(texel, 1) * Channel(tint, 1)),
+						Divide255(Channel(texel, 2) * Channel(tint, 2)), Divide255(Channel(texel, 3) * Channel(tint, 3))));
+				}
+			}
+		}
+	}
+
+	void CSoftwareRenderer::FillRect(int left, int top, int right, int bottom, uint32_t color)
+	{
+		left = std::max(left, 0);
+		top = std::max(top, 0);
+		right = std::min(right, WINDOW_WIDTH);
+		bottom = std::min(bottom, WINDOW_HEIGHT);
+		if (left >= right)
+			return;
+
+		_span.assign(right - left, color);
+		for (int row = top; row < bottom; ++row)
+			BlendRow(&_pixels[row * WINDOW_WIDTH + left], _span.data(), right - left);
+	}
+
+	uint32_t CSoftwareRenderer::Blend(uint32_t destination, uint32_t source)
+	{
+		uint32_t alpha = source >> 24;
+		if (alpha == 255)
+			return source;
+		if (alpha == 0)
+			return Pack(Divide255(Channel(destination, 0) * 255), Divide255(Channel(destination, 1) * 255),
+				Divide255(Channel(destination, 2) * 255), Divide255(Channel(destination, 3) * 255));
+
+		uint32_t result = 0;
+		for (int c = 0; c < 4; ++c)
+			result |= Divide255(Channel(source, c) * alpha + Channel(destination, c) * (255 - alpha)) << (c * 8);
+		return result;
+	}
+
+	void CSoftwareRenderer::BlendRow(uint32_t* destination, const uint32_t* source, int count)
+	{
+		int i = 0;
+#if PUCKMAN_SSE2
+		// four pixels at a time, each channel is widened to 16 bits so the products fit
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi16(255);
+		const __m128i half = _mm_set1_epi16(128);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+
+			__m128i result[2];
+			for (int part = 0; part < 2; ++part)
+			{
+				__m128i sw = part == 0 ? _mm_unpacklo_epi8(s, zero) : _mm_unpackhi_epi8(s, zero);
+				__m128i dw = part == 0 ? _mm_unpacklo_epi8(d, zero) : _mm_unpackhi_epi8(d, zero);
+
+				// spread the alpha of each pixel over its four channels
+				__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sw, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+				__m128i value = _mm_add_epi16(_mm_mullo_epi16(sw, a), _mm_mullo_epi16(dw, _mm_sub_epi16(full, a)));
+
+				// same rounded division by 255 as Divide255
+				value = _mm_add_epi16(value, half);
+				result[part] = _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(result[0], result[1]));
+		}
+#endif
+		for (; i < count; ++i)
+			destination[i] = Blend(destination[i], source[i]);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_SOFTWARERENDERER_H_
+#define PUCKMAN_GRAPHICS_SOFTWARERENDERER_H_
+
+#include <cstdint>
+#include <vector>
+#include "RenderBackend.h"
+#include "Textures.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	/*
+	*  Software renderer class, paints the frames of the game on a framebuffer in memory with the same
+	*  result as the OpenGL backends, so they can be rendered without a GPU or a window; it blends like
+	*  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+	*/
+	class CSoftwareRenderer : public CRenderBackend
+	{
+	public:
+		CSoftwareRenderer() : _scenario{ nullptr } {}
+
+		BackendType Type() override { return SoftwareBackend; }
+
+		// take the sprites and the layer of the walls of a scenario, they must be loaded and
+		// composed (CData::LoadSprites and CScenario::InitMapLayer)
+		bool Init(gamecore::CScenario& scenario) override;
+
+		// clear, paint a frame and the pause message on top when asked
+		void Paint(gamecore::GameFrame& frame, GLfloat alpha, bool paused = false);
+
+		void Clear() override;
+		void DrawLayer() override;
+		// the positions between pixels are filtered like GL_LINEAR does
+		void DrawSprite(GLfloat x, GLfloat y, Clipping clip) override;
+		void DrawQuad(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, GLfloat alpha) override;
+		void DrawQuads(const CQuadLayer& layer) override;
+		// the glyphs are taken from the atlas of the sprites, on the same pixels the batch paints them
+		void DrawString(int x, int y, const char* text, TextSize size, Color color) override;
+
+		// framebuffer of WINDOW_WIDTH x WINDOW_HEIGHT pixels with the RGBA bytes of each one, top row first
+		const std::vector<uint32_t>& Pixels() { return _pixels; }
+
+	private:
+		// blend a row of pixels over another one
+		static void BlendRow(uint32_t* destination, const uint32_t* source, int count);
+		// blend a single pixel over another one
+		static uint32_t Blend(uint32_t destination, uint32_t source);
+		// fill a rectangle of pixels with a color, clipped to the framebuffer
+		void FillRect(int left, int top, int right, int bottom, uint32_t color);
+
+		gamecore::CScenario* _scenario;
+		std::vector<uint32_t> _pixels;
+		// row of a single color blended by FillRect, kept to avoid an allocation per rectangle
+		std::vector<uint32_t> _span;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_SOFTWARERENDERER_H_
@@ -0,0 +1,56 @@
+#include "SpriteBatch.h"
+#include "Textures.h"
+
+namespace graphicscore
+{
+	void CSpriteBatch::Init(CTexture& texture, const LFRect* clippings, size_t count)
+	{
+		_texture = texture.ID();
+
+		GLfloat width = static_cast<GLfloat>(texture.TextureWidth());
+		GLfloat height = static_cast<GLfloat>(texture.TextureHeight());
+
+		_sprites.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const LFRect& clip = clippings[i];
+			_sprites[i] = Sprite{ clip.w, clip.h, clip.x / width, clip.y / height, (clip.x + clip.w) / width, (clip.y + clip.h) / height };
+		}
+	}
+
+	void CSpriteBatch::Flush()
+	{
+		if (_vertices.empty() || _texture == 0)
+		{
+			_vertices.clear();
+			return;
+		}
+
+		// the vertices are already on screen coordinates
+		glLoadIdentity();
+
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, _texture);
+
+		// client side arrays are part of OpenGL 1.1, so they work with the headers shipped with Windows
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &_vertices[0].x);
+		glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &_vertices[0].u);
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &_vertices[0].color);
+
+		glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(_vertices.size()));
+
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisable(GL_TEXTURE_2D);
+		// the current color is undefined after drawing with a color array, the textures expect white
+		glColor4f(1.f, 1.f, 1.f, 1.f);
+
+		++_drawCalls;
+		_quads += static_cast<unsigned int>(_vertices.size() / 4);
+		_vertices.clear();
+	}
+}
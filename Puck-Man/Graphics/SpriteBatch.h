@@ -0,0 +1,89 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_SPRITEBATCH_H_
+#define PUCKMAN_GRAPHICS_SPRITEBATCH_H_
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "../GLUT/glut.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	class CTexture;
+
+	// RGBA bytes of a color, as the batch takes them
+	inline GLuint ColorRGBA(Color color, GLfloat alpha = 1.f)
+	{
+		auto byte = [](GLfloat value) { return static_cast<GLuint>(std::min(std::max(value, 0.f), 1.f) * 255.f + 0.5f); };
+		return byte(colors[color].r) | (byte(colors[color].g) << 8) | (byte(colors[color].b) << 16) | (byte(alpha) << 24);
+	}
+
+	/*
+	*  Sprite batch class, collects the textured quads of a frame in a single vertex array and draws
+	*  all of them with one texture bind and one draw call
+	*/
+	class CSpriteBatch
+	{
+	public:
+		// quads reserved up front, a frame with the full maze uses around 700
+		static const size_t RESERVED_QUADS = 1024;
+		// color that leaves the sprites unchanged
+		static const GLuint WHITE_RGBA = 0xFFFFFFFF;
+
+		CSpriteBatch() : _texture{ 0 }, _drawCalls{ 0 }, _quads{ 0 } { _vertices.reserve(RESERVED_QUADS * 4); }
+		~CSpriteBatch() = default;
+
+		// precompute the texture coordinates of every clipping of the texture
+		template<size_t N>
+		void Init(CTexture& texture, const std::array<LFRect, N>& clippings) { Init(texture, clippings.data(), N); }
+		void Init(CTexture& texture, const LFRect* clippings, size_t count);
+
+		// add the sprite of a clipping with its upper left corner on the given screen position, its
+		// pixels are multiplied by the color (RGBA bytes, white leaves them as they are)
+		void Draw(GLfloat x, GLfloat y, int clip, GLuint color = WHITE_RGBA)
+		{
+			const Sprite& sprite = _sprites[clip];
+			_vertices.push_back(Vertex{ x, y, sprite.left, sprite.top, color });
+			_vertices.push_back(Vertex{ x + sprite.w, y, sprite.right, sprite.top, color });
+			_vertices.push_back(Vertex{ x + sprite.w, y + sprite.h, sprite.right, sprite.bottom, color });
+			_vertices.push_back(Vertex{ x, y + sprite.h, sprite.left, sprite.bottom, color });
+		}
+
+		// draw the quads added since the last flush, it must be called before painting anything
+		// that isn't part of the batch so the order of the scene is kept
+		void Flush();
+
+		// start counting the draw calls and quads of a new frame
+		void Begin() { _drawCalls = 0; _quads = 0; }
+		// draw calls and quads drawn since the frame began
+		unsigned int DrawCalls() { return _drawCalls; }
+		unsigned int Quads() { return _quads; }
+
+	private:
+		// interleaved position, texture coordinates and color, as read by glVertexPointer/glTexCoordPointer/glColorPointer
+		struct Vertex
+		{
+			GLfloat x, y;
+			GLfloat u, v;
+			GLuint color;
+		};
+
+		// size and texture coordinates of a clipping
+		struct Sprite
+		{
+			GLfloat w, h;
+			GLfloat left, top, right, bottom;
+		};
+
+		GLuint _texture;
+		std::vector<Sprite> _sprites;
+		std::vector<Vertex> _vertices;
+
+		unsigned int _drawCalls;
+		unsigned int _quads;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_SPRITEBATCH_H_
@@ -0,0 +1,269 @@
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include "Terminal.h"
+
+#if defined(_WIN32)
+#include <conio.h>
+#include <windows.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING  0x0004
+#endif
+#else
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#define Game        gamecore::CGame::Instance()
+
+namespace graphicscore
+{
+	namespace
+	{
+		// color and characters of each kind of cell
+		const char* const CELL_STYLES[TerminalCell_Size] =
+		{
+			"\x1b[0m",      // empty
+			"\x1b[0;44m",   // wall, on a blue background
+			"\x1b[0;37m",   // pill
+			"\x1b[0;1;37m", // energizer
+			"\x1b[0;1;93m", // Pacman
+			"\x1b[0;1;31m", // red ghost
+			"\x1b[0;1;35m", // pink ghost
+			"\x1b[0;1;36m", // blue ghost
+			"\x1b[0;1;33m", // orange ghost
+		};
+		const char* const CELL_TEXTS[TerminalCell_Size] = { "  ", "  ", ". ", "o ", "C ", "M ", "M ", "M ", "M " };
+
+		// set by Ctrl+C, the terminal is restored before leaving
+		volatile std::sig_atomic_t interrupted = 0;
+		void Interrupt(int) { interrupted = 1; }
+
+#if !defined(_WIN32)
+		// settings of the terminal before the keys were read one at a time
+		termios savedTerminal;
+		bool rawTerminal = false;
+
+		// take a byte from the standard input without waiting
+		bool ReadByte(char& byte) { return rawTerminal && read(STDIN_FILENO, &byte, 1) == 1; }
+#endif
+	}
+
+	bool CTerminal::Run()
+	{
+		// the terminal shares the simulation with the window, only OpenGL is left out
+		if (!Game.Init(false))
+			return false;
+		// nobody steers on a server, the autopilot plays until a key is pressed
+		Game.Autopiloted(true);
+
+#if defined(_WIN32)
+		// the console of Windows 10 understands the escape codes once it's asked to
+		HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+		DWORD mode = 0;
+		if (GetConsoleMode(console, &mode))
+			SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#else
+		// read the keys as they are pressed and without echo
+		if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &savedTerminal) == 0)
+		{
+			termios raw = savedTerminal;
+			raw.c_lflag &= ~(ICANON | ECHO);
+			raw.c_cc[VMIN] = 0;
+			raw.c_cc[VTIME] = 0;
+			rawTerminal = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+		}
+#endif
+		std::signal(SIGINT, Interrupt);
+
+		// the reports of the simulation would scroll the maze away, they are dropped while it's shown
+		std::streambuf* console = std::cout.rdbuf(nullptr);
+
+		// clear the screen and hide the cursor, every cell is written on the first frame
+		std::fputs("\x1b[2J\x1b[?25l", stdout);
+
+		Game.Start();
+		auto start = std::chrono::steady_clock::now();
+		const auto wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / (TICKS_PER_SECOND * 4);
+		bool first = true;
+		unsigned int frames = 0;
+		while (!interrupted && ReadKeys())
+		{
+			// the cells only change with the ticks, the frames in between are skipped
+			auto& frame = Game.Frame();
+			bool paused = Game.State() == GamePaused;
+			if (first || frame.tick != _shownTick || paused != _shownPaused)
+			{
+				Paint(frame, paused);
+				first = false;
+				++frames;
+			}
+			std::this_thread::sleep_for(wait);
+		}
+		Game.Stop();
+		std::cout.rdbuf(console);
+		std::cout.clear();
+
+		// leave the terminal as it was, with the cursor under the maze
+		std::printf("\x1b[0m\x1b[?25h\x1b[%d;1H", SCREEN_HEIGHT_TILES + 2);
+		std::fflush(stdout);
+#if !defined(_WIN32)
+		if (rawTerminal)
+			tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+#endif
+		std::signal(SIGINT, SIG_DFL);
+
+#if DEBUG_CONSOLE
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Terminal: " << frames << " frames in " << seconds << " s, " << (frames ? _bytes / frames : 0) << " bytes per frame" << std::endl;
+#endif
+		return true;
+	}
+
+	void CTerminal::Paint(gamecore::GameFrame& frame, bool paused)
+	{
+		auto& layout = Game.Scenario().ElementsMatrix();
+
+		// what each cell shows now: the elements, then the characters on top of them
+		std::array<uint8_t, SCREEN_WIDTH_TILES * SCREEN_HEIGHT_TILES> cells;
+		for (int y = 0; y < SCREEN_HEIGHT_TILES; ++y)
+		{
+			for (int x = 0; x < SCREEN_WIDTH_TILES; ++x)
+			{
+				uint8_t cell = EmptyCell;
+				if (layout[x][y] == gamecore::Wall)
+					cell = WallCell;
+				else if (frame.pills.Test(x, y))
+					cell = layout[x][y] == gamecore::Energizer ? EnergizerCell : PillCell;
+				cells[y * SCREEN_WIDTH_TILES + x] = cell;
+			}
+		}
+		auto place = [&cells](std::tuple<int, int> position, uint8_t cell)
+		{
+			int x, y;
+			std::tie(x, y) = position;
+			if (x >= 0 && x < SCREEN_WIDTH_TILES && y >= 0 && y < SCREEN_HEIGHT_TILES)
+				cells[y * SCREEN_WIDTH_TILES + x] = cell;
+		};
+		place(frame.pacman.Position(), PacmanCell);
+		for (int ghost = 0; ghost < gamecore::Ghost_Size; ++ghost)
+			place(frame.ghosts[ghost].Position(), static_cast<uint8_t>(GhostCell + ghost));
+
+		// the cursor moves on its own along a row, it's only placed at the start of each run of changes
+		_output.clear();
+		int cursor = -1;
+		char move[24];
+		for (int i = 0; i < SCREEN_WIDTH_TILES * SCREEN_HEIGHT_TILES; ++i)
+		{
+			if (cells[i] == _shown[i])
+				continue;
+			if (cursor != i)
+			{
+				std::snprintf(move, sizeof(move), "\x1b[%d;%dH", i / SCREEN_WIDTH_TILES + 1, (i % SCREEN_WIDTH_TILES) * TERMINAL_CELL_WIDTH + 1);
+				_output += move;
+			}
+			// the cells of the same kind share the color, it's only set when it changes
+			if (_style != CELL_STYLES[cells[i]])
+			{
+				_style = CELL_STYLES[cells[i]];
+				_output += _style;
+			}
+			_output += CELL_TEXTS[cells[i]];
+			_shown[i] = cells[i];
+			cursor = (i + 1) % SCREEN_WIDTH_TILES == 0 ? -1 : i + 1;
+		}
+
+		if (frame.score != _shownScore || paused != _shownPaused)
+		{
+			char status[96];
+			std::snprintf(status, sizeof(status), "\x1b[0m\x1b[%d;1H\x1b[2KScore %d  High %d%s", SCREEN_HEIGHT_TILES + 1,
+				frame.score, frame.highScore, paused ? "  PAUSED" : "");
+			_output += status;
+			_style = CELL_STYLES[EmptyCell];
+			_shownScore = frame.score;
+			_shownPaused = paused;
+		}
+		_shownTick = frame.tick;
+
+		if (!_output.empty())
+		{
+			std::fwrite(_output.data(), 1, _output.size(), stdout);
+			std::fflush(stdout);
+			_bytes += _output.size();
+		}
+	}
+
+	bool CTerminal::ReadKeys()
+	{
+		// the arrows come as escape sequences (Escape [ A..D) or as a prefix and a code on Windows
+		for (;;)
+		{
+			int key;
+			gamecore::Direction direction = gamecore::Left;
+			bool steer = false;
+#if defined(_WIN32)
+			if (!_kbhit())
+				return true;
+			key = _getch();
+			if (key == 0 || key == 224)
+			{
+				switch (_getch())
+				{
+				case 72: direction = gamecore::Up; steer = true; break;
+				case 80: direction = gamecore::Down; steer = true; break;
+				case 75: direction = gamecore::Left; steer = true; break;
+				case 77: direction = gamecore::Right; steer = true; break;
+				}
+			}
+#else
+			char byte;
+			if (!ReadByte(byte))
+				return true;
+			key = static_cast<unsigned char>(byte);
+			char sequence[2];
+			if (key == 27 && ReadByte(sequence[0]) && sequence[0] == '[' && ReadByte(sequence[1]))
+			{
+				switch (sequence[1])
+				{
+				case 'A': direction = gamecore::Up; steer = true; break;
+				case 'B': direction = gamecore::Down; steer = true; break;
+				case 'D': direction = gamecore::Left; steer = true; break;
+				case 'C': direction = gamecore::Right; steer = true; break;
+				}
+				key = 0;
+			}
+#endif
+			if (steer)
+			{
+				Game.Autopiloted(false);
+				Game.Steer(direction);
+				continue;
+			}
+
+			switch (key)
+			{
+			case 'q':
+			case 'Q':
+			case 27:
+				return false;
+			case '\r':
+			case '\n':
+				if (Game.State() == GameRunning)
+					Game.State(GamePaused);
+				else if (Game.State() == GamePaused)
+					Game.State(GameRunning);
+				break;
+			case 'a':
+			case 'A':
+				Game.Autopiloted(!Game.Autopiloted());
+				break;
+			case 'r':
+			case 'R':
+				Game.ResetGhosts();
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_TERMINAL_H_
+#define PUCKMAN_GRAPHICS_TERMINAL_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "../Game/Game.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	// columns of the terminal taken by each tile, two keep the maze close to square
+	static const int TERMINAL_CELL_WIDTH = 2;
+
+	// what a cell of the terminal shows, the ghosts take one value each after GhostCell
+	const enum TerminalCell
+	{
+		EmptyCell = 0,
+		WallCell,
+		PillCell,
+		EnergizerCell,
+		PacmanCell,
+		GhostCell,
+		// element to obtain size of the enumeration
+		TerminalCell_Size = GhostCell + gamecore::Ghost_Size
+	};
+
+	/*
+	*  Terminal class, text frontend that shows the running game with ANSI escape codes on the
+	*  standard output; it attaches to the same simulation as the window and writes only the cells
+	*  that changed since the last frame, so a frame costs a few bytes
+	*/
+	class CTerminal
+	{
+	public:
+		CTerminal() : _shownTick{ 0 }, _shownScore{ -1 }, _shownPaused{ false }, _style{ nullptr }, _bytes{ 0 } { _shown.fill(TerminalCell_Size); }
+		~CTerminal() = default;
+
+		// initialize the game without graphics, start the simulation and show it until the user
+		// quits (q, Escape or Ctrl+C); Enter pauses, 'a' toggles the autopilot, 'r' resets the ghosts
+		// and the arrows steer Pacman
+		bool Run();
+
+	private:
+		// write the cells changed since the last frame and the status line
+		void Paint(gamecore::GameFrame& frame, bool paused);
+		// take the keys pressed since the last call, returns false to quit
+		bool ReadKeys();
+
+		// cells on the terminal in tile order, TerminalCell_Size until they are written
+		std::array<uint8_t, SCREEN_WIDTH_TILES * SCREEN_HEIGHT_TILES> _shown;
+		unsigned int _shownTick;
+		int _shownScore;
+		bool _shownPaused;
+		// color set on the terminal
+		const char* _style;
+
+		// escape codes of a frame, kept to avoid an allocation per frame
+		std::string _output;
+		// bytes written since the start
+		unsigned long long _bytes;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_TERMINAL_H_
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include "Text.h"
+
+namespace graphicscore
+{
+	void RasterizeGlyphs(std::vector<GLuint>& sheet, int& width, int& height, LFRect* clippings)
+	{
+		static const TextSize sizes[TEXT_SIZES] = { TINY, SMALL, NORMAL, BIG };
+
+		// a row of glyphs for each size, the largest one gives the width
+		width = GLYPHS * FONT_WIDTH * FontScale(BIG);
+		height = 0;
+		for (auto size : sizes)
+			height += TextHeight(size);
+		sheet.assign(width * height, 0);
+
+		int top = 0;
+		for (auto size : sizes)
+		{
+			int scale = FontScale(size);
+			for (int glyph = 0; glyph < GLYPHS; ++glyph)
+			{
+				char ch = static_cast<char>(FONT_FIRST + glyph);
+				int left = glyph * FONT_WIDTH * scale;
+				bool blank = true;
+				for (int column = 0; column < FONT_WIDTH; ++column)
+				{
+					for (int row = 0; row < FONT_HEIGHT; ++row)
+					{
+						if (!FontPixel(ch, column, row))
+							continue;
+						blank = false;
+						for (int y = 0; y < scale; ++y)
+							std::fill_n(&sheet[(top + row * scale + y) * width + left + column * scale], scale, 0xFFFFFFFF);
+					}
+				}
+
+				// the blank glyphs take no space on the atlas and are never painted
+				LFRect& clip = clippings[GlyphClipping(size, ch)];
+				if (blank)
+					clip = { 0.f, 0.f, 0.f, 0.f };
+				else
+					clip = { static_cast<GLfloat>(left), static_cast<GLfloat>(top), static_cast<GLfloat>(FONT_WIDTH * scale), static_cast<GLfloat>(TextHeight(size)) };
+			}
+			top += TextHeight(size);
+		}
+	}
+
+	const TextRun& CTextCache::Layout(const char* text, TextSize size)
+	{
+		// find the entry of the text or take one for it
+		Entry* entry = nullptr;
+		for (auto& candidate : _entries)
+		{
+			if (candidate.address == text && candidate.size == size)
+			{
+				entry = &candidate;
+				break;
+			}
+		}
+		if (entry == nullptr)
+		{
+			if (_entries.size() < CACHED_TEXTS)
+			{
+				_entries.emplace_back();
+				entry = &_entries.back();
+			}
+			else
+			{
+				entry = &_entries[_next];
+				_next = (_next + 1) % CACHED_TEXTS;
+			}
+			entry->address = text;
+			entry->size = size;
+			entry->text.clear();
+			entry->run.glyphs.clear();
+		}
+		else if (entry->text == text)
+			return entry->run;
+
+		// lay out the text from its upper left corner
+		entry->text = text;
+		entry->run.glyphs.clear();
+		entry->run.width = TextWidth(text, size);
+		entry->run.height = TextHeight(size);
+		int advance = (FONT_WIDTH + 1) * FontScale(size);
+		int x = 0;
+		for (auto ch = text; *ch != '\0'; ++ch, x += advance)
+		{
+			// the blanks only move the next glyph
+			int clip = GlyphClipping(size, *ch);
+			if (clip != GlyphClipping(size, ' '))
+				entry->run.glyphs.push_back(TextGlyph{ x, 0, clip });
+		}
+		return entry->run;
+	}
+}
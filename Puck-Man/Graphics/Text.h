@@ -0,0 +1,109 @@
+#pragma once
+
+#ifndef PUCKMAN_GRAPHICS_TEXT_H_
+#define PUCKMAN_GRAPHICS_TEXT_H_
+
+#include <string>
+#include <vector>
+#include "Font.h"
+#include "Textures.h"
+#include "../Common/Utils.h"
+
+namespace graphicscore
+{
+	// characters of the font and sizes rasterized for each one of them
+	static const int GLYPHS = FONT_LAST - FONT_FIRST + 1;
+	static const int TEXT_SIZES = 4;
+	// clippings of the sprites followed by the glyphs of every size
+	static const int CLIPPINGS = Clipping_Size + TEXT_SIZES * GLYPHS;
+	// layouts kept by each text cache
+	static const size_t CACHED_TEXTS = 16;
+
+	// order of the text sizes on the glyphs
+	inline int SizeIndex(TextSize size)
+	{
+		switch (size)
+		{
+		case TINY:   return 0;
+		case SMALL:  return 1;
+		case NORMAL: return 2;
+		default:     return 3;
+		}
+	}
+
+	// pixels of the font for each one of its pixels on a text size, close to the height of the
+	// stroke font that was used before
+	inline int FontScale(TextSize size)
+	{
+		static const int scales[TEXT_SIZES] = { 3, 4, 6, 8 };
+		return scales[SizeIndex(size)];
+	}
+
+	// clipping of the glyph of a character rasterized on a text size, the characters out of the
+	// font take the blank one
+	inline int GlyphClipping(TextSize size, char ch)
+	{
+		int index = static_cast<unsigned char>(ch);
+		if (index < FONT_FIRST || index > FONT_LAST)
+			index = ' ';
+		return Clipping_Size + SizeIndex(size) * GLYPHS + index - FONT_FIRST;
+	}
+
+	// exact size in pixels of a text, the glyphs are separated by a column of the font
+	inline int TextWidth(const char* text, TextSize size)
+	{
+		int length = static_cast<int>(std::char_traits<char>::length(text));
+		return length == 0 ? 0 : (length * (FONT_WIDTH + 1) - 1) * FontScale(size);
+	}
+	inline int TextHeight(TextSize size) { return FONT_HEIGHT * FontScale(size); }
+	// distance from the top of a text to its baseline
+	inline int TextAscent(TextSize size) { return FONT_ASCENT * FontScale(size); }
+
+	// rasterize the glyphs of every text size on a sheet of white pixels and set their clippings,
+	// the blank glyphs are left without size
+	void RasterizeGlyphs(std::vector<GLuint>& sheet, int& width, int& height, LFRect* clippings);
+
+	// glyph of a text, placed from the upper left corner of the text
+	struct TextGlyph
+	{
+		int x, y;
+		int clip;
+	};
+
+	// glyphs of a text with its size
+	struct TextRun
+	{
+		std::vector<TextGlyph> glyphs;
+		int width, height;
+	};
+
+	/*
+	*  Text cache class, keeps the layout of the last texts so the ones painted on every frame are
+	*  laid out once; the texts are found by their address and checked by their content, so a buffer
+	*  that changes its text gets a new layout on the same entry without allocating
+	*/
+	class CTextCache
+	{
+	public:
+		CTextCache() : _next{ 0 } { _entries.reserve(CACHED_TEXTS); }
+		~CTextCache() = default;
+
+		// get the layout of a text, valid until the next call
+		const TextRun& Layout(const char* text, TextSize size);
+
+	private:
+		struct Entry
+		{
+			const char* address;
+			TextSize size;
+			std::string text;
+			TextRun run;
+		};
+
+		std::vector<Entry> _entries;
+		// entry replaced when the cache is full
+		size_t _next;
+	};
+}
+
+#endif // PUCKMAN_GRAPHICS_TEXT_H_
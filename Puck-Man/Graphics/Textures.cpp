@@ -1,59 +1,81 @@
+#include <algorithm>
+#include <cstring>
+#include "Atlas.h"
+#include "Text.h"
 #include "Textures.h"
 
 namespace graphicscore
 {
-	bool CTexture::LoadTextureFromFile(std::string filename)
+	bool CTexture::LoadImageFromFile(std::string filename, std::vector<GLuint>& pixels, int& width, int& height)
 	{
-		// texture loading result
-		bool textureLoaded = false;
+		// image loading result
+		bool imageLoaded = false;
 
 		// generate and set current image ID on DevIL
 		ILuint imgID = 0;
 		ilGenImages(1, &imgID);
 		ilBindImage(imgID);
 
-		// load the texture file
-		ILboolean status = ilLoadImage(filename.c_str());
-
-		// check if the image was loaded successfully
-		if (status == IL_TRUE)
+		// load the image file and convert it to RGBA
+		if (ilLoadImage(filename.c_str()) == IL_TRUE && ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE) == IL_TRUE)
 		{
-			// convert image to RGBA
-			status = ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
-			if (status == IL_TRUE)
-			{
-				// initialize the dimensions of the image
-				_imageWidth = static_cast<GLuint>(ilGetInteger(IL_IMAGE_WIDTH));
-				_imageHeight = static_cast<GLuint>(ilGetInteger(IL_IMAGE_HEIGHT));
-
-				// calculate required texture dimensions
-				_textureWidth = PowerOfTwo(_imageWidth);
-				_textureHeight = PowerOfTwo(_imageHeight);
-
-				// texture is of different size that the actual image
-				if (_imageWidth != _textureWidth || _imageHeight != _textureHeight)
-				{
-					// place the image at the upper left
-					iluImageParameter(ILU_PLACEMENT, ILU_UPPER_LEFT);
-
-					// resize the image
-					iluEnlargeCanvas(static_cast<int>(_textureWidth), static_cast<int>(_textureHeight), 1);
-				}
-
-				// create texture form file pixels
-				textureLoaded = LoadTextureFromPixels32(reinterpret_cast<GLuint*>(ilGetData()));
-			}
+			width = ilGetInteger(IL_IMAGE_WIDTH);
+			height = ilGetInteger(IL_IMAGE_HEIGHT);
 
-			// delete file from memory
-			ilDeleteImages(1, &imgID);
+			GLuint* data = reinterpret_cast<GLuint*>(ilGetData());
+			pixels.assign(data, data + width * height);
+			imageLoaded = true;
 		}
 
+		// delete file from memory
+		ilDeleteImages(1, &imgID);
+
 #if DEBUG_CONSOLE
-		if (!textureLoaded)
-			std::cout << "ERROR: Unable to load texture: " << filename << std::endl;
+		if (!imageLoaded)
+			std::cout << "ERROR: Unable to load image: " << filename << std::endl;
 #endif
 
-		return textureLoaded;
+		return imageLoaded;
+	}
+
+	bool CTexture::LoadTextureFromFile(std::string filename)
+	{
+		std::vector<GLuint> pixels;
+		int width, height;
+		if (!LoadImageFromFile(filename, pixels, width, height))
+			return false;
+
+		// calculate required texture dimensions
+		int textureWidth = width, textureHeight = height;
+		if (!NonPowerOfTwo())
+		{
+			textureWidth = PowerOfTwo(width);
+			textureHeight = PowerOfTwo(height);
+		}
+
+		// texture is of different size that the actual image, place the image at the upper left
+		if (textureWidth != width || textureHeight != height)
+		{
+			std::vector<GLuint> canvas(textureWidth * textureHeight, 0);
+			for (int y = 0; y < height; ++y)
+				std::copy(pixels.begin() + y * width, pixels.begin() + (y + 1) * width, canvas.begin() + y * textureWidth);
+			pixels.swap(canvas);
+		}
+
+		// create texture form file pixels
+		return LoadTextureFromPixels32(pixels.data(), width, height, textureWidth, textureHeight);
+	}
+
+	bool CTexture::LoadTextureFromPixels32(GLuint* pixels, int imageWidth, int imageHeight, int textureWidth, int textureHeight)
+	{
+		FreeTexture();
+
+		_imageWidth = imageWidth;
+		_imageHeight = imageHeight;
+		_textureWidth = textureWidth;
+		_textureHeight = textureHeight;
+
+		return LoadTextureFromPixels32(pixels);
 	}
 
 	bool CTexture::LoadTextureFromPixels32(GLuint* pixels)
@@ -92,6 +114,20 @@ namespace graphicscore
 		}
 	}
 
+	bool CTexture::NonPowerOfTwo()
+	{
+		// OpenGL 2.0 made them part of the core, before that they come with an extension
+		static const bool supported = []
+		{
+			const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+			const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+			if (version != nullptr && version[0] >= '2' && version[0] <= '9')
+				return true;
+			return extensions != nullptr && std::strstr(extensions, "GL_ARB_texture_non_power_of_two") != nullptr;
+		}();
+		return supported;
+	}
+
 	GLuint CTexture::PowerOfTwo(GLuint num)
 	{
 		if (num != 0)
@@ -107,16 +143,22 @@ namespace graphicscore
 		return num;
 	}
 
+	CData::CData() : _spritesWidth{ 0 }, _spritesHeight{ 0 }, _clippings(CLIPPINGS)
+	{
+	}
+
 	bool CData::Init()
 	{
-		// load the main texture with the sprites
-		if (!_texture.LoadTextureFromFile("Textures/Pacman.png"))
-		{
-#if DEBUG_CONSOLE
-			std::cout << "ERROR: Unable to load non-power-of-two texture" << std::endl;
-#endif
+		return LoadSprites(!CTexture::NonPowerOfTwo()) && UploadSprites();
+	}
+
+	bool CData::LoadSprites(bool powerOfTwo)
+	{
+		// load the sheet with the sprites, only the clippings are uploaded to the texture
+		std::vector<GLuint> sheet;
+		int sheetWidth, sheetHeight;
+		if (!CTexture::LoadImageFromFile("Textures/Pacman.png", sheet, sheetWidth, sheetHeight))
 			return false;
-		}
 
 		// set the clipping information of the game sprites
 		// dual line corners
@@ -180,6 +222,49 @@ namespace graphicscore
 																				   // yellow ghost
 		_clippings[LO_GHOST] = { 150, 367, SIZE_OF_CHARACTER, SIZE_OF_CHARACTER }; // 46
 
+		// the glyphs of the text share the atlas, so the texts go through the sprite batch
+		std::vector<GLuint> glyphs;
+		int glyphsWidth, glyphsHeight;
+		RasterizeGlyphs(glyphs, glyphsWidth, glyphsHeight, _clippings.data());
+
+		// pack the clippings on an atlas and move them to their place on it
+		CAtlasPacker packer;
+		packer.Pack(_clippings, powerOfTwo);
+
+		_spritesWidth = packer.Width();
+		_spritesHeight = packer.Height();
+		if (powerOfTwo)
+		{
+			_spritesWidth = CTexture::PowerOfTwo(_spritesWidth);
+			_spritesHeight = CTexture::PowerOfTwo(_spritesHeight);
+		}
+		_sprites.assign(_spritesWidth * _spritesHeight, 0);
+
+		// each image fills its own clippings, the rest are left without size
+		std::vector<LFRect> sprites(_clippings.begin(), _clippings.begin() + Clipping_Size);
+		sprites.resize(CLIPPINGS, LFRect{ 0.f, 0.f, 0.f, 0.f });
+		packer.Compose(sprites, sheet.data(), sheetWidth, _sprites.data(), _spritesWidth);
+		std::vector<LFRect> text(Clipping_Size, LFRect{ 0.f, 0.f, 0.f, 0.f });
+		text.insert(text.end(), _clippings.begin() + Clipping_Size, _clippings.end());
+		packer.Compose(text, glyphs.data(), glyphsWidth, _sprites.data(), _spritesWidth);
+		_clippings = packer.Placed();
+
+#if DEBUG_CONSOLE
+		std::cout << "Sprites atlas: " << _spritesWidth << "x" << _spritesHeight << " from a "
+			<< sheetWidth << "x" << sheetHeight << " sheet and " << TEXT_SIZES << " sizes of glyphs" << std::endl;
+#endif
+
+		return true;
+	}
+
+	bool CData::UploadSprites()
+	{
+		if (!_texture.LoadTextureFromPixels32(_sprites.data(), _spritesWidth, _spritesHeight, _spritesWidth, _spritesHeight))
+			return false;
+
+		// the texture coordinates don't change, compute them once for the batch
+		_batch.Init(_texture, _clippings.data(), _clippings.size());
+
 		return true;
 	}
 
@@ -234,4 +319,77 @@ namespace graphicscore
 			glDisable(GL_TEXTURE_2D);
 		}
 	}
+
+	void CData::BeginLayer()
+	{
+		_layerPixels.assign(WINDOW_WIDTH * WINDOW_HEIGHT, 0);
+	}
+
+	void CData::DrawOnLayer(int x, int y, Clipping clip)
+	{
+		if (_layerPixels.empty() || _sprites.empty())
+			return;
+
+		const LFRect& rect = _clippings[clip];
+		int clipX = static_cast<int>(rect.x), clipY = static_cast<int>(rect.y);
+
+		// the tiles don't overlap, so the pixels are copied as they are, leaving out the
+		// ones that fall outside of the window
+		for (int row = 0; row < static_cast<int>(rect.h); ++row)
+		{
+			int ty = y + row;
+			if (ty < 0 || ty >= WINDOW_HEIGHT)
+				continue;
+			for (int column = 0; column < static_cast<int>(rect.w); ++column)
+			{
+				int tx = x + column;
+				if (tx < 0 || tx >= WINDOW_WIDTH)
+					continue;
+				_layerPixels[ty * WINDOW_WIDTH + tx] = _sprites[(clipY + row) * _spritesWidth + clipX + column];
+			}
+		}
+	}
+
+	bool CData::UploadLayer()
+	{
+		bool loaded;
+		if (CTexture::NonPowerOfTwo())
+			loaded = _layer.LoadTextureFromPixels32(_layerPixels.data(), WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_WIDTH, WINDOW_HEIGHT);
+		else
+		{
+			// place the layer at the upper left of a power of two canvas
+			int width = CTexture::PowerOfTwo(WINDOW_WIDTH), height = CTexture::PowerOfTwo(WINDOW_HEIGHT);
+			std::vector<GLuint> canvas(width * height, 0);
+			for (int y = 0; y < WINDOW_HEIGHT; ++y)
+				std::copy(_layerPixels.begin() + y * WINDOW_WIDTH, _layerPixels.begin() + (y + 1) * WINDOW_WIDTH, canvas.begin() + y * width);
+			loaded = _layer.LoadTextureFromPixels32(canvas.data(), WINDOW_WIDTH, WINDOW_HEIGHT, width, height);
+		}
+
+#if DEBUG_CONSOLE
+		if (!loaded)
+			std::cout << "ERROR: Unable to create the layer of the walls" << std::endl;
+#endif
+		return loaded;
+	}
+
+	void CData::RenderLayer()
+	{
+		if (_layer.ID() == 0)
+			return;
+
+		glLoadIdentity();
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, _layer.ID());
+
+		GLfloat width = static_cast<GLfloat>(_layer.TextureWidth());
+		GLfloat height = static_cast<GLfloat>(_layer.TextureHeight());
+		glBegin(GL_QUADS);
+		glTexCoord2f(0.f, 0.f); glVertex2f(0.f, 0.f);
+		glTexCoord2f(1.f, 0.f); glVertex2f(width, 0.f);
+		glTexCoord2f(1.f, 1.f); glVertex2f(width, height);
+		glTexCoord2f(0.f, 1.f); glVertex2f(0.f, height);
+		glEnd();
+
+		glDisable(GL_TEXTURE_2D);
+	}
 }
@@ -9,8 +9,10 @@
 #include <array>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "../DevIL/il.h"
 #include "../DevIL/ilu.h"
+#include "SpriteBatch.h"
 #include "../Common/Utils.h"
 
 namespace graphicscore
@@ -123,6 +125,18 @@ namespace graphicscore
 		// method to load texture from a file
 		bool LoadTextureFromFile(std::string filename);
 
+		// method to create a texture from RGBA pixels already laid out with the texture dimensions
+		bool LoadTextureFromPixels32(GLuint* pixels, int imageWidth, int imageHeight, int textureWidth, int textureHeight);
+
+		// method to load the RGBA pixels of an image file without creating a texture
+		static bool LoadImageFromFile(std::string filename, std::vector<GLuint>& pixels, int& width, int& height);
+
+		// check if the textures can have any size, it needs a current OpenGL context
+		static bool NonPowerOfTwo();
+
+		// method to get the next power of 2 size for a texture
+		static GLuint PowerOfTwo(GLuint num);
+
 	private:
 		// ID of the texture
 		GLuint _ID;
@@ -138,32 +152,61 @@ namespace graphicscore
 
 		// method to release a texture
 		void FreeTexture();
-
-		// method to get the next power of 2 size for a texture
-		GLuint PowerOfTwo(GLuint num);
 	};
 
 	class CData
 	{
 	public:
-		CData() = default;
+		CData();
 		~CData() = default;
 
 		CTexture& Texture() { return _texture; }
+		// clipping of a sprite or of a glyph of the font (GlyphClipping) on the atlas
 		LFRect& Clippings(int index) { return _clippings[index]; }
+		// batch where the sprites of each frame are collected
+		CSpriteBatch& Batch() { return _batch; }
 
 		// load the texture with the game sprites
 		bool Init();
+		// load the sprites and rasterize the glyphs of the font on an atlas kept on memory, it doesn't need OpenGL
+		bool LoadSprites(bool powerOfTwo);
+		// create the texture of the sprites from the atlas
+		bool UploadSprites();
+
+		// pixels of the atlas of the sprites, rows of SpritesWidth pixels
+		const std::vector<GLuint>& Sprites() { return _sprites; }
+		int SpritesWidth() { return _spritesWidth; }
+		int SpritesHeight() { return _spritesHeight; }
 
-		// render a texture on screen
+		// render a texture on screen right away, the sprites of the game go through the batch
 		void RenderTexture(GLfloat x, GLfloat y, LFRect* clip = nullptr);
 
+		// compose the sprites that never change on a layer of the size of the window, the layer
+		// is composed on memory and then uploaded as a texture
+		void BeginLayer();
+		void DrawOnLayer(int x, int y, Clipping clip);
+		bool UploadLayer();
+		// pixels of the layer, rows of WINDOW_WIDTH pixels
+		const std::vector<GLuint>& LayerPixels() { return _layerPixels; }
+		// paint the layer on screen with a single quad
+		void RenderLayer();
+
 	private:
 		// member variable to hold the game texture
 		CTexture _texture;
+		// atlas with the pixels of the texture
+		std::vector<GLuint> _sprites;
+		int _spritesWidth, _spritesHeight;
+
+		// member variable to save the clipping information of the sprites and the glyphs
+		std::vector<LFRect> _clippings;
+
+		// sprites of the frame with the texture coordinates of the clippings
+		CSpriteBatch _batch;
 
-		// member variable to save the clipping information of the sprites
-		std::array<LFRect, Clipping_Size> _clippings;
+		// static layer of the window and its pixels
+		CTexture _layer;
+		std::vector<GLuint> _layerPixels;
 	};
 }
 
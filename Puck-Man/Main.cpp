@@ -1,5 +1,11 @@
+#include <cstring>
 #include <iostream>
+#include <string>
+#include "Game/Game.h"
+#include "Game/LevelFile.h"
+#include "Graphics/Golden.h"
 #include "Graphics/Graphics.h"
+#include "Graphics/Terminal.h"
 
 using graphicscore::CGraphics;
 
@@ -10,6 +16,51 @@ using graphicscore::CGraphics;
 
 int main(int argc, char **argv)
 {
+	std::string capture;
+	graphicscore::CaptureSource source = graphicscore::ReadbackSource;
+	for (int i = 1; i < argc; ++i)
+	{
+		// paint only the tiles that change on each frame
+		if (std::strcmp(argv[i], "--incremental") == 0)
+			CGraphics::Instance().Incremental(true);
+		// show the game with text on the terminal instead of a window
+		else if (std::strcmp(argv[i], "--terminal") == 0)
+			return graphicscore::CTerminal{}.Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+		// paint the scene at its own size and scale it to the window by whole factors
+		else if (std::strcmp(argv[i], "--upscale") == 0)
+			CGraphics::Instance().Upscaled(true);
+		// save the frames shown on screen to a file, a named pipe or the standard output with "-"
+		else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+			capture = argv[++i];
+		// take the captured frames from the software renderer instead of reading them back
+		else if (std::strcmp(argv[i], "--software-capture") == 0)
+			source = graphicscore::SoftwareSource;
+		// select how the frames are painted: immediate, batched or null
+		else if (std::strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+		{
+			++i;
+			for (int type = 0; type < graphicscore::BackendType_Size; ++type)
+				if (std::strcmp(argv[i], graphicscore::CRenderBackend::Name(static_cast<graphicscore::BackendType>(type))) == 0)
+					CGraphics::Instance().Backend(static_cast<graphicscore::BackendType>(type));
+		}
+		// play the level of another description instead of Scenarios/Level.txt
+		else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+			gamecore::CGame::Instance().Level(argv[++i]);
+		// compile the scenario and its navigation grid to the binary level mapped by the next starts,
+		// until the level description changes again; it takes the level given before it
+		else if (std::strcmp(argv[i], "--compile-level") == 0)
+			return gamecore::CLevelFile::Compile(gamecore::CGame::Instance().Level()) ? EXIT_SUCCESS : EXIT_FAILURE;
+		// paint the fixed states of the golden images without a window and compare them with the
+		// stored ones, or store them again after a change of the picture that is intended
+		else if (std::strcmp(argv[i], "--golden-check") == 0 || std::strcmp(argv[i], "--golden-record") == 0)
+		{
+			bool record = std::strcmp(argv[i], "--golden-record") == 0;
+			return graphicscore::CGoldenImages{}.Run(record) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+	if (!capture.empty())
+		CGraphics::Instance().Capture(capture, source);
+
 	// initialize the game
 	if (!CGraphics::Instance().Init())
 	{